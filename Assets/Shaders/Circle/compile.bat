@@ -1,3 +0,0 @@
-C:/VulkanSDK/1.4.309.0/Bin/glslc.exe circle_shader.vert -o circle_vert.spv
-C:/VulkanSDK/1.4.309.0/Bin/glslc.exe circle_shader.frag -o circle_frag.spv
-pause
\ No newline at end of file
@@ -1,3 +0,0 @@
-C:/VulkanSDK/1.4.309.0/Bin/glslc.exe rectangle_shader.vert -o rectangle_vert.spv
-C:/VulkanSDK/1.4.309.0/Bin/glslc.exe rectangle_shader.frag -o rectangle_frag.spv
-pause
\ No newline at end of file
@@ -0,0 +1,18 @@
+#version 450
+
+layout(set = 0, binding = 0) uniform sampler2D chunk;
+
+layout(location = 0) in vec2 fragTexCoord;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    // Chunks hold the layers blended over transparent black, which leaves the color multiplied by alpha
+    vec4 color = texture(chunk, fragTexCoord);
+
+    if (color.a == 0.0) {
+        discard;
+    }
+
+    outColor = vec4(color.rgb / color.a, color.a);
+}
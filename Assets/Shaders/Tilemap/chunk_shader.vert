@@ -0,0 +1,17 @@
+#version 450
+
+layout(push_constant) uniform ChunkParameters {
+    mat4 viewProjection;
+    vec4 rect;
+} parameters;
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec2 inTexCoord;
+
+layout(location = 0) out vec2 fragTexCoord;
+
+void main() {
+    vec2 worldPosition = parameters.rect.xy + inPosition.xy * parameters.rect.zw;
+    gl_Position = parameters.viewProjection * vec4(worldPosition, 0.0, 1.0);
+    fragTexCoord = inTexCoord;
+}
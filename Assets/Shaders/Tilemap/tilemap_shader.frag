@@ -0,0 +1,53 @@
+#version 450
+
+#extension GL_EXT_nonuniform_qualifier : require
+
+struct ImageRect {
+    float translateX;
+    float translateY;
+    float scaleX;
+    float scaleY;
+};
+
+struct FrameTableEntry {
+    ImageRect rect;
+    uint textureIndex;
+};
+
+layout(set = 2, binding = 0) uniform sampler2D textures[];
+
+layout(std430, set = 0, binding = 2) readonly buffer FrameTable {
+    FrameTableEntry frames[];
+} frameTable;
+
+layout(std430, set = 1, binding = 0) readonly buffer TileBuffer {
+    uint ids[];
+} tiles;
+
+layout(push_constant) uniform TilemapParameters {
+    mat4 viewProjection;
+    uint columns;
+    uint rows;
+    uint firstTile;
+} parameters;
+
+layout(location = 0) in vec2 mapPosition;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    uvec2 tile = min(uvec2(mapPosition), uvec2(parameters.columns, parameters.rows) - 1);
+    uint id = tiles.ids[parameters.firstTile + tile.y * parameters.columns + tile.x];
+
+    // Zero marks a tile without a sprite on this layer
+    if (id == 0) {
+        discard;
+    }
+
+    FrameTableEntry frame = frameTable.frames[id - 1];
+    vec2 uv = fract(mapPosition);
+    vec2 texCoord = vec2(frame.rect.translateX, frame.rect.translateY) + uv * vec2(frame.rect.scaleX, frame.rect.scaleY);
+
+    // Explicit level of detail, the derivatives of the texture coordinates jump at every tile border
+    outColor = textureLod(textures[nonuniformEXT(frame.textureIndex)], texCoord, 0.0);
+}
@@ -0,0 +1,19 @@
+#version 450
+
+layout(push_constant) uniform TilemapParameters {
+    mat4 viewProjection;
+    uint columns;
+    uint rows;
+    uint firstTile;
+} parameters;
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec2 inTexCoord;
+
+layout(location = 0) out vec2 mapPosition;
+
+void main() {
+    // The unit quad is stretched over the whole map, the rasterizer clips it to the visible part
+    mapPosition = inPosition.xy * vec2(parameters.columns, parameters.rows);
+    gl_Position = parameters.viewProjection * vec4(mapPosition, 0.0, 1.0);
+}
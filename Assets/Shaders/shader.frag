@@ -8,7 +8,7 @@ layout(location = 2) flat in uint textureIndex;
 
 layout(location = 0) out vec4 outColor;
 
-layout(set = 0, binding = 1) uniform sampler2D textures[];
+layout(set = 3, binding = 0) uniform sampler2D textures[];
 
 void main() {
     outColor = texture(textures[nonuniformEXT(textureIndex)], fragTexCoord);
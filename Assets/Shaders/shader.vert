@@ -7,16 +7,25 @@ struct ImageRect {
     float scaleY;
 };
 
-struct ObjectData{
-	mat4 modelMatrix;
-	ImageRect spriteFrame;
-	uint textureIndex;
+struct ObjectData {
+    vec2 position;
+    uint size;
+    uint frameIndex;
+};
+
+struct FrameTableEntry {
+    ImageRect rect;
+    uint textureIndex;
 };
 
 layout(binding = 0) uniform CameraUniformData {
     mat4 viewProjection;
 } camera;
 
+layout(std430, set = 0, binding = 2) readonly buffer FrameTable {
+    FrameTableEntry frames[];
+} frameTable;
+
 layout(std430, set = 1, binding = 0) readonly buffer ObjectBuffer {
     ObjectData objects[];
 } objectBuffer;
@@ -35,18 +44,16 @@ layout(location = 2) flat out uint textureIndex;
 void main() {
     uint realIndex = instanceIndexBuffer.indices[gl_InstanceIndex];
     ObjectData instanceData = objectBuffer.objects[realIndex];
+    FrameTableEntry frame = frameTable.frames[instanceData.frameIndex];
 
-    vec4 position = camera.viewProjection * instanceData.modelMatrix * vec4(inPosition, 1.0);
+    // Negative sizes flip the sprite through its texture coordinates, mirroring the quad would flip its winding
+    vec2 size = unpackHalf2x16(instanceData.size);
+    vec2 uv = mix(inTexCoord, 1.0 - inTexCoord, lessThan(size, vec2(0.0)));
+
+    vec4 position = camera.viewProjection * vec4(instanceData.position + inPosition.xy * abs(size), 0.0, 1.0);
     gl_Position = position;
 
     fragColor = vec3(position.x, position.y, position.z);
-    textureIndex = instanceData.textureIndex;
-
-    mat3 uvTransform = mat3(
-        vec3(instanceData.spriteFrame.scaleX, 0, 0),
-        vec3(0, instanceData.spriteFrame.scaleY, 0),
-        vec3(instanceData.spriteFrame.translateX, instanceData.spriteFrame.translateY, 1.0)
-    );
-
-    fragTexCoord = (uvTransform * vec3(inTexCoord, 1.0)).xy;
-}
\ No newline at end of file
+    textureIndex = frame.textureIndex;
+    fragTexCoord = vec2(frame.rect.translateX, frame.rect.translateY) + uv * vec2(frame.rect.scaleX, frame.rect.scaleY);
+}
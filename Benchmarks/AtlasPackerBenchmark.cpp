@@ -0,0 +1,109 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "../Rendering/AtlasPacker.h"
+
+namespace
+{
+    typedef struct
+    {
+        const char* name;
+        uint16_t minimumSide;
+        uint16_t maximumSide;
+        size_t frameCount;
+    } Workload;
+
+    constexpr Workload WORKLOADS[] =
+    {
+        { "tiles 32x32", 32, 32, 2048 },
+        { "sprites 16-64", 16, 64, 2048 },
+        { "mixed 8-256", 8, 256, 1024 },
+    };
+
+    constexpr uint32_t PAGE_SIZES[] = { 1024, 2048, 4096 };
+    constexpr size_t FRAMES_PER_ENTRY = 8;
+
+    std::vector<AtlasEntry> makeEntries(const Workload& workload, uint32_t seed)
+    {
+        std::mt19937 random(seed);
+        std::uniform_int_distribution<uint32_t> side(workload.minimumSide, workload.maximumSide);
+        std::vector<AtlasEntry> entries{};
+
+        for (size_t first = 0; first < workload.frameCount; first += FRAMES_PER_ENTRY)
+        {
+            std::vector<AtlasFrame> frames{};
+
+            for (size_t frame = first; frame < std::min(first + FRAMES_PER_ENTRY, workload.frameCount); frame++)
+            {
+                frames.push_back({ 0, 0, static_cast<uint16_t>(side(random)), static_cast<uint16_t>(side(random)) });
+            }
+
+            entries.push_back({ static_cast<uint32_t>(entries.size()), "", std::move(frames) });
+        }
+
+        return entries;
+    }
+}
+
+/**
+ * Packs generated atlases of typical frame sizes into pages of several sizes and prints the packing time and how
+ * much of the cropped pages the frames cover.
+ * Usage: AtlasPackerBenchmark [iterations] [seed]
+ */
+int main(int argc, char** argv)
+{
+    const int iterations = argc > 1 ? std::max(1, std::atoi(argv[1])) : 20;
+    const auto seed = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 1u;
+
+    std::printf("%-14s %6s %7s %6s %10s %10s %10s\n", "workload", "page", "frames", "pages", "mean ms", "min ms",
+        "occupancy");
+
+    for (const auto& workload : WORKLOADS)
+    {
+        const auto entries = makeEntries(workload, seed);
+
+        for (const uint32_t pageSize : PAGE_SIZES)
+        {
+            const AtlasPacker packer(pageSize);
+            std::vector<double> milliseconds{};
+            AtlasPackResult result{};
+
+            for (int i = 0; i < iterations; i++)
+            {
+                result = packer.pack(entries);
+                milliseconds.push_back(result.packingMilliseconds);
+            }
+
+            // Weighted by page height, so a small last page does not skew the share
+            double coveredArea = 0.0;
+            double pageArea = 0.0;
+
+            for (size_t page = 0; page < result.pageHeights.size(); page++)
+            {
+                const double area = static_cast<double>(result.pageWidth) * result.pageHeights[page];
+                coveredArea += area * result.pageOccupancy[page];
+                pageArea += area;
+            }
+
+            std::printf(
+                "%-14s %6u %7zu %6zu %10.3f %10.3f %9.1f%%\n",
+                workload.name,
+                pageSize,
+                result.frameCount,
+                result.pageHeights.size(),
+                std::accumulate(milliseconds.begin(), milliseconds.end(), 0.0) / iterations,
+                *std::ranges::min_element(milliseconds),
+                pageArea > 0.0 ? coveredArea / pageArea * 100.0 : 0.0);
+        }
+    }
+
+    return 0;
+}
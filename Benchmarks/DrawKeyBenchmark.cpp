@@ -0,0 +1,136 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "../Rendering/DrawKey.h"
+
+namespace
+{
+    constexpr size_t REQUEST_COUNTS[] = { 10'000, 100'000, 1'000'000 };
+
+    // Like a frame of the game: a few layers, sprites ordered by their y position and three pipelines
+    constexpr uint32_t LAYER_COUNT = 4;
+    constexpr uint32_t ORDER_COUNT = 2000;
+    constexpr size_t PIPELINE_COUNT = 3;
+
+    std::vector<DrawRequest> makeRequests(size_t count, uint32_t seed)
+    {
+        std::mt19937 random(seed);
+        std::uniform_int_distribution<uint32_t> layer(0, LAYER_COUNT - 1);
+        std::uniform_int_distribution<uint32_t> order(0, ORDER_COUNT - 1);
+        std::uniform_int_distribution<size_t> pipeline(0, PIPELINE_COUNT - 1);
+        std::vector<DrawRequest> requests{};
+        requests.reserve(count);
+
+        // Instances are submitted in ascending order, which the draw key relies on to match the stable sort
+        for (size_t i = 0; i < count; i++)
+        {
+            requests.push_back({ pipeline(random), i, layer(random), order(random) });
+        }
+
+        return requests;
+    }
+
+    template<typename Function>
+    double measureMilliseconds(Function&& function)
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        function();
+
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+}
+
+/**
+ * Sorts generated draw requests the way drawScene used to, by copying and stable sorting the requests, and the way it
+ * does now, by packing draw keys and radix sorting them. Prints the time of both and fails when the radix sort
+ * disagrees with std::sort on the same keys.
+ * Usage: DrawKeyBenchmark [iterations] [seed]
+ */
+int main(int argc, char** argv)
+{
+    const int iterations = argc > 1 ? std::max(1, std::atoi(argv[1])) : 5;
+    const auto seed = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 1u;
+
+    std::printf("%9s %16s %16s %16s %16s %8s\n", "requests", "stable mean ms", "stable min ms", "radix mean ms",
+        "radix min ms", "speedup");
+
+    for (const size_t requestCount : REQUEST_COUNTS)
+    {
+        const auto requests = makeRequests(requestCount, seed);
+        std::vector<DrawRequest> sortedRequests{};
+        std::vector<uint64_t> keys{};
+        std::vector<uint64_t> scratch{};
+        std::vector<double> stableMilliseconds{};
+        std::vector<double> radixMilliseconds{};
+
+        for (int i = 0; i < iterations; i++)
+        {
+            stableMilliseconds.push_back(measureMilliseconds([&]
+            {
+                sortedRequests = requests;
+                std::ranges::stable_sort(sortedRequests, [](const auto& a, const auto& b)
+                {
+                    if (a.layer != b.layer)
+                    {
+                        return a.layer < b.layer;
+                    }
+
+                    return a.orderInLayer < b.orderInLayer;
+                });
+            }));
+
+            radixMilliseconds.push_back(measureMilliseconds([&]
+            {
+                keys.clear();
+
+                for (const auto& request : requests)
+                {
+                    keys.push_back(DrawKey::pack(request));
+                }
+
+                DrawKey::sort(keys, scratch);
+            }));
+        }
+
+        std::vector<uint64_t> expectedKeys{};
+        expectedKeys.reserve(requests.size());
+
+        for (const auto& request : requests)
+        {
+            expectedKeys.push_back(DrawKey::pack(request));
+        }
+
+        std::sort(expectedKeys.begin(), expectedKeys.end());
+
+        if (keys != expectedKeys)
+        {
+            std::printf("Radix sort of %zu keys differs from std::sort\n", requestCount);
+            return 1;
+        }
+
+        const double stableMean = std::accumulate(stableMilliseconds.begin(), stableMilliseconds.end(), 0.0) /
+            iterations;
+        const double radixMean = std::accumulate(radixMilliseconds.begin(), radixMilliseconds.end(), 0.0) /
+            iterations;
+
+        std::printf(
+            "%9zu %16.3f %16.3f %16.3f %16.3f %7.2fx\n",
+            requestCount,
+            stableMean,
+            *std::ranges::min_element(stableMilliseconds),
+            radixMean,
+            *std::ranges::min_element(radixMilliseconds),
+            radixMean > 0.0 ? stableMean / radixMean : 0.0);
+    }
+
+    return 0;
+}
@@ -55,14 +55,6 @@ void Camera::updatePosition(glm::vec3 worldPosition)
     glm::vec3 up     = glm::vec3(0.0f, 1.0f, 0.0f);
     glm::mat4 view = glm::lookAt(eye, center, up);
 
-    glm::mat4 projection = glm::ortho(
-        0.0f,
-        m_extentsWidth,
-        0.0f,
-        m_extentsHeight);
-
-    m_viewProjectionMatrix = projection * view;
-
     const auto halfWidth = m_visibleArea.width / 2;
     const auto halfHeight = m_visibleArea.height / 2;
 
@@ -72,6 +64,16 @@ void Camera::updatePosition(glm::vec3 worldPosition)
     m_cameraFrustum.y = worldPosition.y - halfHeight;
     m_cameraFrustum.width = m_visibleArea.width;
     m_cameraFrustum.height = m_visibleArea.height;
+
+    // Projects world units directly, so panning and zooming only change this matrix and never the instance data.
+    // The visible area is the window extent divided by the pixels per unit, which keeps one unit at that many pixels.
+    glm::mat4 projection = glm::ortho(
+        m_cameraFrustum.x,
+        m_cameraFrustum.toX,
+        m_cameraFrustum.y,
+        m_cameraFrustum.toY);
+
+    m_viewProjectionMatrix = projection * view;
 }
 
 const glm::mat4& Camera::getViewProjectionMatrix() const
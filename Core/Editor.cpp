@@ -18,6 +18,8 @@
 #include "TextureAtlasParser.h"
 #include "TileTypes.h"
 #include "Timestep.h"
+#include "../Rendering/CpuProfiler.h"
+#include "../Rendering/Logger.h"
 #include "../Rendering/VulkanRenderer.h"
 
 #include "../Core/World.h"
@@ -62,12 +64,11 @@ Editor::Editor()
 
 	initImGui();
 
-	m_atlasEntries = TextureAtlasParser::parseAtlas(assetsBasePath / "Textures/textures.atlas");
+	AssetManager assetManager(assetsBasePath);
+	const auto atlas = assetManager.loadAtlas("Textures/textures.atlas", TaskPriority::High);
 
-	for (const auto& atlas: m_atlasEntries)
-	{
-		m_textureIndices.push_back(m_renderer->loadTexture(atlas));
-	}
+	m_atlasEntries = std::vector<AtlasEntry>(atlas.get().entries);
+	m_textureIndices = m_renderer->loadAtlas(atlas.get());
 
     m_world = std::make_unique<World>();
 
@@ -202,9 +203,11 @@ void Editor::RunLoop()
 {
     auto startOfLastUpdate = std::chrono::high_resolution_clock::now();
 	float secondsSinceLastUpdate = 0.0f;
+	PROFILE_THREAD_NAME("Main");
 
 	while (!glfwWindowShouldClose(m_window))
     {
+		PROFILE_SCOPE("Frame");
 		glfwPollEvents();
 
         const auto startOfFrame = std::chrono::high_resolution_clock::now();
@@ -221,7 +224,7 @@ void Editor::RunLoop()
 
 		startOfLastUpdate = startOfCurrentUpdate;
 		secondsSinceLastUpdate += step.deltaSeconds;
-		std::cout << "Seconds since last update: " << secondsSinceLastUpdate << std::endl;
+		LOG_EVERY_N(FRAMES_PER_SECOND, LogLevel::Debug, "Frame", "Seconds since last update: {}", secondsSinceLastUpdate);
 
 		if (secondsSinceLastUpdate >= SECONDS_PER_FRAME)
 		{
@@ -248,8 +251,14 @@ void Editor::RunLoop()
         const auto frameDuration = endOfFrame - startOfFrame;
         const auto renderDuration = endOfRender - startOfRender;
 
-        std::cout << "Frame:" << std::chrono::duration_cast<std::chrono::milliseconds>(frameDuration).count() << std::endl;
-        std::cout << "Render:" << std::chrono::duration_cast<std::chrono::milliseconds>(renderDuration).count() << std::endl;
+        // Roughly once per second, the writer thread formats and prints off the frame
+        LOG_EVERY_N(
+        	FRAMES_PER_SECOND,
+        	LogLevel::Info,
+        	"Frame",
+        	"Frame: {} ms, render: {} ms",
+        	std::chrono::duration<double, std::milli>(frameDuration).count(),
+        	std::chrono::duration<double, std::milli>(renderDuration).count());
     }
 
 	vkDeviceWaitIdle(m_vulkanResources->m_logicalDevice);
@@ -278,6 +287,77 @@ void Editor::updateUI()
 	ImGui::Text("Selected tile frame: %d", m_selectedFrame);
 	ImGui::Text("Selected layer: %d", m_selectedLayer);
 
+	const MemoryStatistics memoryStatistics = m_vulkanResources->m_memoryAllocator->getStatistics();
+	ImGui::Text(
+		"GPU memory: %.1f / %.1f MiB",
+		static_cast<double>(memoryStatistics.usedBytes) / (1024.0 * 1024.0),
+		static_cast<double>(memoryStatistics.allocatedBytes) / (1024.0 * 1024.0));
+	ImGui::Text(
+		"Allocations: %zu (%zu blocks, %zu dedicated)",
+		memoryStatistics.allocationCount,
+		memoryStatistics.blockCount,
+		memoryStatistics.dedicatedAllocationCount);
+	ImGui::Text("Uploaded: %.1f KiB", static_cast<double>(m_renderer->getUploadedBytes()) / 1024.0);
+	ImGui::Text("GPU wait: %.2f ms", m_renderer->getFrameWaitMilliseconds());
+
+	if (m_renderer->getGpuProfiler().isAvailable() && ImGui::Checkbox("GPU profiler", &m_gpuProfilingEnabled))
+	{
+		m_renderer->setGpuProfilingEnabled(m_gpuProfilingEnabled);
+	}
+
+	if (m_gpuProfilingEnabled)
+	{
+		const GpuProfiler& profiler = m_renderer->getGpuProfiler();
+		ImGui::Text("GPU frame: %.3f ms", profiler.getFrameMilliseconds());
+
+		for (const GpuScopeTiming& scope : profiler.getResults())
+		{
+			if (scope.id != GpuProfiler::NO_ID)
+			{
+				ImGui::Text("  %s %u: %.3f ms", scope.name, scope.id, scope.milliseconds);
+			}
+			else
+			{
+				ImGui::Text("  %s: %.3f ms", scope.name, scope.milliseconds);
+			}
+
+			if (profiler.hasPipelineStatistics())
+			{
+				ImGui::SameLine();
+				ImGui::Text(
+					"(%llu vs, %llu fs)",
+					static_cast<unsigned long long>(scope.vertexInvocations),
+					static_cast<unsigned long long>(scope.fragmentInvocations));
+			}
+		}
+	}
+
+	const ChunkCacheStatistics& chunkStatistics = m_renderer->getChunkCacheStatistics();
+	ImGui::Text(
+		"Chunks: %zu / %zu resident, %.1f / %.1f MiB",
+		chunkStatistics.residentChunks,
+		chunkStatistics.maxChunks,
+		static_cast<double>(chunkStatistics.residentBytes) / (1024.0 * 1024.0),
+		static_cast<double>(chunkStatistics.budgetBytes) / (1024.0 * 1024.0));
+	ImGui::Text(
+		"Chunk hits: %llu, misses: %llu, evictions: %llu",
+		static_cast<unsigned long long>(chunkStatistics.hits),
+		static_cast<unsigned long long>(chunkStatistics.misses),
+		static_cast<unsigned long long>(chunkStatistics.evictions));
+
+	const TextureResidencyStatistics& textureStatistics = m_renderer->getTextureResidencyStatistics();
+	ImGui::Text(
+		"Textures: %zu / %zu resident, %.1f / %.1f MiB",
+		textureStatistics.residentTextures,
+		textureStatistics.textureCount,
+		static_cast<double>(textureStatistics.residentBytes) / (1024.0 * 1024.0),
+		static_cast<double>(textureStatistics.budgetBytes) / (1024.0 * 1024.0));
+	ImGui::Text(
+		"Texture hits: %llu, misses: %llu, evictions: %llu",
+		static_cast<unsigned long long>(textureStatistics.hits),
+		static_cast<unsigned long long>(textureStatistics.misses),
+		static_cast<unsigned long long>(textureStatistics.evictions));
+
 	if (ImGui::Button("Save"))
 	{
 		saveMap();
@@ -384,6 +464,8 @@ void Editor::setSelectedTile()
 
 void Editor::drawMap()
 {
+	m_renderer->updateTilemap(*m_map);
+
 	// const auto& frustum = m_camera->getFrustum();
 	//
 	// const auto& tiles = m_map->getTiles();
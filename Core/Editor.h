@@ -53,6 +53,7 @@ private:
 
     bool m_runAnimations = false;
     bool m_showImGui = true;
+    bool m_gpuProfilingEnabled = false;
 
     void initImGui();
     void updateAnimations(const Timestep& step);
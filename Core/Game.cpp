@@ -4,15 +4,28 @@
 
 #include "Game.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include "Input.h"
 #include "MapSerializer.h"
 #include "UiRectangle.h"
+#include "../Rendering/CpuProfiler.h"
+#include "../Rendering/Logger.h"
+#include "../Rendering/Shader.h"
 #include "../Rendering/VulkanRenderer.h"
 
 Game::Game()
 {
+	m_startTime = std::chrono::high_resolution_clock::now();
+	m_drawRequests.reserve(10000);
+
+    const std::filesystem::path assetsBasePath = std::filesystem::path("..") / "Assets";
+
+    // Images decode on the asset threads while the window, the device and the pipelines are created
+    m_assetManager = std::make_unique<AssetManager>(assetsBasePath);
+    const auto atlas = m_assetManager->loadAtlas("Textures/textures.atlas", TaskPriority::High);
+
 	glfwInit();
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
 
@@ -37,110 +50,14 @@ Game::Game()
         m_validationLayers,
         instanceExtensions);
 
-    const std::filesystem::path assetsBasePath = std::filesystem::path("..") / "Assets";
-
-    m_renderer = std::make_unique<VulkanRenderer>(
+    auto renderer = std::make_unique<VulkanRenderer>(
         assetsBasePath,
         m_vulkanResources,
         PIXELS_PER_UNIT);
-    m_renderer->initialize();
-
-	m_spriteBufferIndex = m_renderer->registerDataType<SpriteRenderData>(10000);
-	m_spritePipelineIndex = m_renderer->registerShader(
-		assetsBasePath / "Shaders" / "vert.spv",
-		assetsBasePath / "Shaders" / "frag.spv",
-		m_spriteBufferIndex);
-
-	m_circlesBufferIndex = m_renderer->registerDataType<Circle>(100);
-	m_circlesPipelineIndex = m_renderer->registerShader(
-			assetsBasePath / "Shaders" / "Circle" / "circle_vert.spv",
-			assetsBasePath / "Shaders" / "Circle" / "circle_frag.spv",
-			m_circlesBufferIndex);
-
-	m_rectanglesBufferIndex = m_renderer->registerDataType<UiRectangle>(100);
-	m_rectanglesPipelineIndex = m_renderer->registerShader(
-			assetsBasePath / "Shaders" / "Rectangles" / "rectangle_vert.spv",
-			assetsBasePath / "Shaders" / "Rectangles" / "rectangle_frag.spv",
-			m_rectanglesBufferIndex);
-
-    m_atlasEntries = TextureAtlasParser::parseAtlas(assetsBasePath / "Textures/textures.atlas");
-
-    for (const auto& atlas: m_atlasEntries)
-    {
-        m_textureIndices.push_back(m_renderer->loadTexture(atlas));
-    }
-
-    m_world = std::make_unique<World>();
-
-    auto& animationSystem = m_world->getAnimationSystem();
-    animationSystem.addAnimationData(
-    {
-        .name = "open_treasure",
-        .keyFrames =
-        {
-            KeyFrame{.afterFrames = 0, .frame = 0 },
-            KeyFrame{.afterFrames = 100, .frame = 1 },
-            KeyFrame{.afterFrames = 100, .frame = 0 }
-        },
-        .loops = false
-    });
+    renderer->initialize();
+    m_renderer = std::move(renderer);
 
-	animationSystem.addAnimationData(
-		{
-		.name = "treasure_idle_closed",
-		.keyFrames =
-		{
-			KeyFrame { .afterFrames = 0, .frame = 0 }
-		}
-		});
-	animationSystem.addAnimator(Animator(animationSystem.getAnimationDataIndexByName("treasure_idle_closed")));
-
-    animationSystem.addAnimationData(
-    {
-        .name = "blob_idle",
-        .keyFrames =
-        {
-            KeyFrame{.afterFrames = 0, .frame = 0 },
-            KeyFrame{.afterFrames = 30, .frame = 1 },
-            KeyFrame{.afterFrames = 30, .frame = 2 },
-            KeyFrame{.afterFrames = 30, .frame = 3 },
-            KeyFrame{.afterFrames = 30, .frame = 0 },
-        },
-        .loops = true
-    });
-    animationSystem.addAnimator(Animator(animationSystem.getAnimationDataIndexByName("blob_idle")));
-
-    m_world->addGameObject(
-            { 30, 30, 1},
-            0,
-            Sprite{.textureIndex = 8},
-            0);
-
-    m_world->addGameObject(
-        { 29, 30, 1},
-        0,
-        Sprite{.textureIndex = 9},
-        1);
-
-	const auto filePath = std::filesystem::path( assetsBasePath / "Maps" / "Level1.fecmap");
-	const auto result = MapSerializer::deserializeMap(filePath);
-    m_map = std::make_unique<Map>(result.map);
-
-    const auto windowExtent = m_vulkanWindow->getWindowExtent();
-
-    const CameraArea visibleArea
-    {
-        static_cast<float>(windowExtent.width) / static_cast<float>(PIXELS_PER_UNIT),
-        static_cast<float>(windowExtent.height) / static_cast<float>(PIXELS_PER_UNIT),
-        1.0f,
-        10.0f
-    };
-
-    m_camera = std::make_unique<Camera>(
-        glm::vec3((float)m_map->getColumns() / 2.0f, (float)m_map->getRows() / 2.0f, 0.0f),
-        visibleArea,
-        windowExtent.width,
-        windowExtent.height);
+    initializeScene(assetsBasePath, atlas.get(), m_vulkanWindow->getWindowExtent());
 
 	m_inputSystem = std::make_unique<Input>();
 	m_inputSystem->init(m_window);
@@ -235,13 +152,130 @@ Game::Game()
 	glfwSetWindowUserPointer(m_window, m_windowContext.get());
 }
 
+Game::Game(std::unique_ptr<IRenderer> renderer, WindowExtent windowExtent)
+{
+	m_startTime = std::chrono::high_resolution_clock::now();
+	m_drawRequests.reserve(10000);
+
+    const std::filesystem::path assetsBasePath = std::filesystem::path("..") / "Assets";
+
+    m_assetManager = std::make_unique<AssetManager>(assetsBasePath);
+    const auto atlas = m_assetManager->loadAtlas("Textures/textures.atlas", TaskPriority::High);
+
+    m_renderer = std::move(renderer);
+    initializeScene(assetsBasePath, atlas.get(), windowExtent);
+}
+
+void Game::initializeScene(
+	const std::filesystem::path& assetsBasePath,
+	const LoadedAtlas& atlas,
+	WindowExtent windowExtent)
+{
+	const auto shaderDirectory = Shader::getBinaryDirectory();
+
+	m_spriteBufferIndex = m_renderer->registerDataType<SpriteRenderData>(10000);
+	m_spritePipelineIndex = m_renderer->registerShader(
+		shaderDirectory / "vert.spv",
+		shaderDirectory / "frag.spv",
+		m_spriteBufferIndex,
+		true);
+
+	m_circlesBufferIndex = m_renderer->registerDataType<Circle>(100);
+	m_circlesPipelineIndex = m_renderer->registerShader(
+			shaderDirectory / "Circle" / "circle_vert.spv",
+			shaderDirectory / "Circle" / "circle_frag.spv",
+			m_circlesBufferIndex);
+
+	m_rectanglesBufferIndex = m_renderer->registerDataType<UiRectangle>(100);
+	m_rectanglesPipelineIndex = m_renderer->registerShader(
+			shaderDirectory / "Rectangles" / "rectangle_vert.spv",
+			shaderDirectory / "Rectangles" / "rectangle_frag.spv",
+			m_rectanglesBufferIndex);
+	m_renderer->createPipelines();
+
+    m_atlasEntries = std::vector<AtlasEntry>(atlas.entries);
+    m_textureIndices = m_renderer->loadAtlas(atlas);
+
+    m_world = std::make_unique<World>();
+
+    auto& animationSystem = m_world->getAnimationSystem();
+    animationSystem.addAnimationData(
+    {
+        .name = "open_treasure",
+        .keyFrames =
+        {
+            KeyFrame{.afterFrames = 0, .frame = 0 },
+            KeyFrame{.afterFrames = 100, .frame = 1 },
+            KeyFrame{.afterFrames = 100, .frame = 0 }
+        },
+        .loops = false
+    });
+
+	animationSystem.addAnimationData(
+		{
+		.name = "treasure_idle_closed",
+		.keyFrames =
+		{
+			KeyFrame { .afterFrames = 0, .frame = 0 }
+		}
+		});
+	animationSystem.addAnimator(Animator(animationSystem.getAnimationDataIndexByName("treasure_idle_closed")));
+
+    animationSystem.addAnimationData(
+    {
+        .name = "blob_idle",
+        .keyFrames =
+        {
+            KeyFrame{.afterFrames = 0, .frame = 0 },
+            KeyFrame{.afterFrames = 30, .frame = 1 },
+            KeyFrame{.afterFrames = 30, .frame = 2 },
+            KeyFrame{.afterFrames = 30, .frame = 3 },
+            KeyFrame{.afterFrames = 30, .frame = 0 },
+        },
+        .loops = true
+    });
+    animationSystem.addAnimator(Animator(animationSystem.getAnimationDataIndexByName("blob_idle")));
+
+    m_world->addGameObject(
+            { 30, 30, 1},
+            0,
+            Sprite{.textureIndex = 8},
+            0);
+
+    m_world->addGameObject(
+        { 29, 30, 1},
+        0,
+        Sprite{.textureIndex = 9},
+        1);
+
+	const auto filePath = std::filesystem::path( assetsBasePath / "Maps" / "Level1.fecmap");
+	const auto result = MapSerializer::deserializeMap(filePath);
+    m_map = std::make_unique<Map>(result.map);
+
+    const CameraArea visibleArea
+    {
+        static_cast<float>(windowExtent.width) / static_cast<float>(PIXELS_PER_UNIT),
+        static_cast<float>(windowExtent.height) / static_cast<float>(PIXELS_PER_UNIT),
+        1.0f,
+        10.0f
+    };
+
+    m_camera = std::make_unique<Camera>(
+        glm::vec3((float)m_map->getColumns() / 2.0f, (float)m_map->getRows() / 2.0f, 0.0f),
+        visibleArea,
+        windowExtent.width,
+        windowExtent.height);
+}
+
 void Game::RunLoop()
 {
 	auto startOfLastUpdate = std::chrono::high_resolution_clock::now();
 	float secondsSinceLastUpdate = 0.0f;
+	PROFILE_THREAD_NAME("Main");
 
 	while (!glfwWindowShouldClose(m_window))
 	{
+		PROFILE_SCOPE("Frame");
 		glfwPollEvents();
 
 		const auto startOfFrame = std::chrono::high_resolution_clock::now();
@@ -257,7 +291,7 @@ void Game::RunLoop()
 		};
 
 		secondsSinceLastUpdate += step.deltaSeconds;
-		std::cout << "Seconds since last update: " << secondsSinceLastUpdate << std::endl;
+		LOG_EVERY_N(FRAMES_PER_SECOND, LogLevel::Debug, "Frame", "Seconds since last update: {}", secondsSinceLastUpdate);
 
 		if (secondsSinceLastUpdate >= SECONDS_PER_FRAME)
 		{
@@ -277,52 +311,89 @@ void Game::RunLoop()
 		const auto frameDuration = endOfFrame - startOfFrame;
 		const auto renderDuration = endOfRender - startOfRender;
 
-		std::cout << "Frame:" << std::chrono::duration_cast<std::chrono::milliseconds>(frameDuration).count() << std::endl;
-		std::cout << "Render:" << std::chrono::duration_cast<std::chrono::milliseconds>(renderDuration).count() << std::endl;
+		// Roughly once per second, the writer thread formats and prints off the frame
+		LOG_EVERY_N(
+			FRAMES_PER_SECOND,
+			LogLevel::Info,
+			"Frame",
+			"Frame: {} ms, render: {} ms",
+			std::chrono::duration<double, std::milli>(frameDuration).count(),
+			std::chrono::duration<double, std::milli>(renderDuration).count());
 	}
 }
 
-void Game::draw()
+void Game::RunFrames(uint32_t frameCount)
 {
-	m_drawRequests.clear();
+	// Fixed steps keep runs comparable, nothing waits for the wall clock
+	const Timestep step
+	{
+		SECONDS_PER_FRAME * 1000.0f,
+		SECONDS_PER_FRAME
+	};
 
-	const auto& frustum = m_camera->getFrustum();
-	const auto offset = glm::vec3(frustum.x, frustum.y, 0);
+	const auto start = std::chrono::high_resolution_clock::now();
+	PROFILE_THREAD_NAME("Main");
 
-	const auto& tiles = m_map->getTiles();
-	const auto& gameObjects = m_world->getGameObjects();
+	for (uint32_t frame = 0; frame < frameCount; frame++)
+	{
+		PROFILE_SCOPE("Frame");
+		m_world->getAnimationSystem().update(step);
+		draw();
+	}
 
-	const glm::vec3 scale{PIXELS_PER_UNIT, PIXELS_PER_UNIT, 1 };
+	const double milliseconds = std::chrono::duration<double, std::milli>(
+		std::chrono::high_resolution_clock::now() - start).count();
 
-	size_t objectIndex = 0;
-	uint8_t maxMapLayer = 0;
+	Logger::log(
+		LogLevel::Info,
+		"Game",
+		"Ran {} frames in {} ms, {} ms per frame",
+		frameCount,
+		milliseconds,
+		milliseconds / std::max(frameCount, 1u));
+}
 
-	for (const auto& tile : tiles)
+void Game::draw()
+{
+	extractDrawRequests();
+	m_renderer->drawScene(*m_camera, m_drawRequests, nullptr);
+
+	if (!m_firstFrameDrawn)
 	{
-		if (static_cast<float>(tile.column + 1) < frustum.x || static_cast<float>(tile.column) > frustum.toX ||
-			static_cast<float>(tile.row + 1) < frustum.y || static_cast<float>(tile.row) > frustum.toY)
-		{
-			continue;
-		}
+		m_firstFrameDrawn = true;
+		Logger::log(
+			LogLevel::Info,
+			"Game",
+			"Time to first frame: {} ms",
+			std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - m_startTime).count());
+	}
+}
 
-		const glm::vec3 worldPos = glm::vec3(tile.column, tile.row, 1);
+void Game::extractDrawRequests()
+{
+	PROFILE_SCOPE("Draw extraction");
+	m_drawRequests.clear();
 
-		for (const auto& layer : tile.tileLayers)
-		{
-			drawSprite(objectIndex, layer.layer, worldPos, scale, layer.sprite, offset);
-			objectIndex++;
-			maxMapLayer = glm::max(maxMapLayer, layer.layer);
-		}
-	}
+	const auto& frustum = m_camera->getFrustum();
 
-	const size_t gameObjectsLayer = maxMapLayer + 1;
+	const auto& gameObjects = m_world->getGameObjects();
+
+	// The tilemap is drawn below all draw requests, so game objects no longer need a layer above the map
+	m_renderer->updateTilemap(*m_map);
+
+	const glm::vec3 scale{1, 1, 1};
 
-	for (const auto& gameObject : gameObjects)
+	// Objects keep their instance across frames, so set skips the upload of objects that did not change
+	const bool cullOnGpu = m_renderer->isGpuCullingActive();
+
+	for (size_t objectIndex = 0; objectIndex < gameObjects.size(); objectIndex++)
 	{
+		const auto& gameObject = gameObjects[objectIndex];
 		const auto worldPosition = gameObject.getWorldPosition();
 
-		if ((worldPosition.x + 1) < frustum.x || worldPosition.x > frustum.toX ||
-			(worldPosition.y + 1) < frustum.y || worldPosition.y > frustum.toY)
+		if (!cullOnGpu &&
+			((worldPosition.x + 1) < frustum.x || worldPosition.x > frustum.toX ||
+			(worldPosition.y + 1) < frustum.y || worldPosition.y > frustum.toY))
 		{
 			continue;
 		}
@@ -340,13 +411,11 @@ void Game::draw()
 				.currentFrame = animationData->keyFrames[animator.m_currentKeyFrame].frame
 			};
 
-			drawSprite(objectIndex,gameObjectsLayer, worldPosition, scale, sprite, offset);
-			objectIndex++;
+			drawSprite(objectIndex, GAME_OBJECTS_LAYER, worldPosition, scale, sprite);
 		}
 		else
 		{
-			drawSprite(objectIndex,gameObjectsLayer, worldPosition, scale, gameObject.getSprite(), offset);
-			objectIndex++;
+			drawSprite(objectIndex, GAME_OBJECTS_LAYER, worldPosition, scale, gameObject.getSprite());
 		}
 	}
 
@@ -369,8 +438,6 @@ void Game::draw()
 			CIRCLE_LAYER,
 			i);
 	}
-
-	m_renderer->drawScene(*m_camera, m_drawRequests, nullptr);
 }
 
 void Game::drawSelectedCharacter()
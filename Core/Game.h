@@ -8,6 +8,7 @@
 #define VK_USE_PLATFORM_WIN32_KHR
 #define GLFW_INCLUDE_VULKAN
 
+#include <chrono>
 #include <memory>
 #include <vector>
 #include <glm/vec2.hpp>
@@ -20,14 +21,16 @@
 #include "Map.h"
 #include "WindowContext.h"
 #include "World.h"
-#include "../Rendering/VulkanRenderer.h"
+#include "../Rendering/AssetManager.h"
+#include "../Rendering/IRenderer.h"
+#include "../Rendering/VulkanWindow.h"
 #include "../Rendering/SpriteRenderData.h"
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/packing.hpp>
 
 class Camera;
 class Map;
 class World;
-class VulkanRenderer;
 class VulkanResources;
 class VulkanWindow;
 
@@ -41,17 +44,31 @@ public:
 
     Game();
 
+    /**
+     * Runs the game without a window or input on renderer, which is initialized already. windowExtent only sizes
+     * the camera.
+     */
+    Game(std::unique_ptr<IRenderer> renderer, WindowExtent windowExtent);
+
     void RunLoop();
 
+    /**
+     * Updates and draws frameCount frames back to back with a fixed time step and prints the average frame time.
+     * Does not poll events, which makes it usable without a window.
+     */
+    void RunFrames(uint32_t frameCount);
+
 private:
+    const size_t GAME_OBJECTS_LAYER = 0;
     const size_t CIRCLE_LAYER = 9000;
 
     std::vector<AtlasEntry> m_atlasEntries;
 
-    GLFWwindow* m_window;
+    GLFWwindow* m_window = nullptr;
     std::shared_ptr<VulkanWindow> m_vulkanWindow;
     std::shared_ptr<VulkanResources> m_vulkanResources;
-    std::unique_ptr<VulkanRenderer> m_renderer;
+    std::unique_ptr<IRenderer> m_renderer;
+    std::unique_ptr<AssetManager> m_assetManager;
     std::unique_ptr<World> m_world;
     std::unique_ptr<Map> m_map;
     std::vector<size_t> m_textureIndices;
@@ -66,12 +83,20 @@ private:
     size_t m_rectanglesBufferIndex = 0;
     size_t m_rectanglesPipelineIndex = 0;
 
-    std::vector<DrawRequest> m_drawRequests{10000};
+    std::vector<DrawRequest> m_drawRequests{};
     bool m_circleIsNext = true;
 
     int32_t m_selectedGameObjectIndex = -1;
 
+    std::chrono::high_resolution_clock::time_point m_startTime{};
+    bool m_firstFrameDrawn = false;
+
+    void initializeScene(
+        const std::filesystem::path& assetsBasePath,
+        const LoadedAtlas& atlas,
+        WindowExtent windowExtent);
     void draw();
+    void extractDrawRequests();
     void drawSelectedCharacter();
 
     [[nodiscard]] glm::vec2 screenToWorld(const glm::vec2& screenPos) const;
@@ -82,26 +107,17 @@ private:
         size_t layer,
         const glm::vec3& worldPosition,
         const glm::vec3& scale,
-        const Sprite& sprite,
-        const glm::vec3& cameraOffset)
+        const Sprite& sprite)
     {
         auto& spriteBuffer = m_renderer->getDataBuffer<SpriteRenderData>(m_spriteBufferIndex);
 
-        const glm::vec3 screenPosition = glm::vec3(
-             (static_cast<float>(worldPosition.x) - cameraOffset.x) * static_cast<float>(m_renderer->getPixelsPerUnit()),
-             (static_cast<float>(worldPosition.y) - cameraOffset.y) * static_cast<float>(m_renderer->getPixelsPerUnit()),
-             worldPosition.z);
-
-        const auto& texture = m_renderer->getTexture(sprite.textureIndex);
-        auto& spriteObject = spriteBuffer.m_data[objectIndex];
-
-        spriteObject.modelMatrix =
-            glm::translate(glm::mat4(1.0f), screenPosition) *
-            glm::scale(glm::mat4(1), scale);
-        spriteObject.spriteFrame = texture.getFrame(sprite.currentFrame);
-        spriteObject.textureIndex = sprite.textureIndex;
+        // Instances stay in world units, the camera uniform maps them to the screen
+        SpriteRenderData spriteObject{};
+        spriteObject.position = glm::vec2(worldPosition);
+        spriteObject.size = glm::packHalf2x16(glm::vec2(scale));
+        spriteObject.frameIndex = m_renderer->getFrameIndex(sprite.textureIndex, sprite.currentFrame);
 
-        spriteBuffer.m_dataSize = std::max(objectIndex + 1, spriteBuffer.m_dataSize);
+        spriteBuffer.set(objectIndex, spriteObject);
 
         // TODO: pipelines should be registered and referenced correctly here
         m_drawRequests.emplace_back(m_spritePipelineIndex, objectIndex, layer, worldPosition.y);
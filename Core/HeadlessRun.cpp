@@ -0,0 +1,94 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include "HeadlessRun.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "MapSerializer.h"
+#include "../Rendering/CpuProfiler.h"
+#include "../Rendering/AssetManager.h"
+#include "../Rendering/Logger.h"
+
+HeadlessRun::HeadlessRun(uint32_t width, uint32_t height)
+{
+    const std::filesystem::path assetsBasePath = std::filesystem::path("..") / "Assets";
+
+    AssetManager assetManager(assetsBasePath);
+    const auto atlas = assetManager.loadAtlas("Textures/textures.atlas", TaskPriority::High);
+
+    // No validation layers, the machines this runs on usually do not have them installed
+    m_vulkanResources = std::make_shared<VulkanResources>(WindowExtent{ width, height });
+    m_vulkanResources->initialize(false, {}, {});
+
+    Logger::log(
+        LogLevel::Info,
+        "Headless",
+        "Rendering on {}",
+        std::string_view(m_vulkanResources->m_physicalDeviceProperties.deviceName));
+
+    m_renderer = std::make_unique<VulkanRenderer>(assetsBasePath, m_vulkanResources, PIXELS_PER_UNIT);
+    m_renderer->initialize();
+    m_renderer->loadAtlas(atlas.get());
+
+    const auto result = MapSerializer::deserializeMap(assetsBasePath / "Maps" / "Level1.fecmap");
+    m_map = std::make_unique<Map>(result.map);
+
+    const CameraArea visibleArea
+    {
+        static_cast<float>(width) / static_cast<float>(PIXELS_PER_UNIT),
+        static_cast<float>(height) / static_cast<float>(PIXELS_PER_UNIT),
+        1.0f,
+        10.0f
+    };
+
+    m_camera = std::make_unique<Camera>(
+        glm::vec3((float)m_map->getColumns() / 2.0f, (float)m_map->getRows() / 2.0f, 0.0f),
+        visibleArea,
+        static_cast<float>(width),
+        static_cast<float>(height));
+}
+
+void HeadlessRun::run(uint32_t frameCount, const std::filesystem::path& outputPath)
+{
+    m_renderer->updateTilemap(*m_map);
+    m_renderer->setReadbackEnabled(false);
+
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    PROFILE_THREAD_NAME("Main");
+
+    for (uint32_t frame = 0; frame < frameCount; frame++)
+    {
+        PROFILE_SCOPE("Frame");
+
+        // Reading back costs a full copy of the image, so only the frame that gets written out pays for it
+        if (frame + 1 == frameCount && !outputPath.empty())
+        {
+            m_renderer->setReadbackEnabled(true);
+        }
+
+        m_renderer->drawScene(*m_camera, {}, nullptr);
+    }
+
+    vkQueueWaitIdle(m_vulkanResources->m_graphicsQueue);
+
+    const double milliseconds = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+
+    Logger::log(
+        LogLevel::Info,
+        "Headless",
+        "Rendered {} frames in {} ms, {} ms per frame",
+        frameCount,
+        milliseconds,
+        milliseconds / std::max(frameCount, 1u));
+
+    if (!outputPath.empty() && frameCount > 0)
+    {
+        m_renderer->saveLastFrame(outputPath);
+        Logger::log(LogLevel::Info, "Headless", "Wrote the last frame to {}", outputPath);
+    }
+}
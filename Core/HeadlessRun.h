@@ -0,0 +1,45 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef HEADLESSRUN_H
+#define HEADLESSRUN_H
+
+#include <filesystem>
+#include <memory>
+
+#include "Camera.h"
+#include "Map.h"
+#include "../Rendering/VulkanRenderer.h"
+#include "../Rendering/VulkanResources.h"
+
+/**
+ * Renders the first level without a window, for throughput benchmarks and golden image checks on machines without
+ * a display. Works with software Vulkan implementations like lavapipe.
+ */
+class HeadlessRun
+{
+public:
+    static constexpr uint32_t PIXELS_PER_UNIT = 64;
+
+    HeadlessRun(uint32_t width, uint32_t height);
+
+    /**
+     * Draws frameCount frames and prints the average frame time. Only the last frame is read back and written to
+     * outputPath, unless it is empty.
+     */
+    void run(uint32_t frameCount, const std::filesystem::path& outputPath);
+
+    /**
+     * Frames drawn with and without the chunk cache are expected to match, so golden images are compared both ways.
+     */
+    void setChunkCacheEnabled(bool enabled) { m_renderer->setChunkCacheEnabled(enabled); }
+
+private:
+    std::shared_ptr<VulkanResources> m_vulkanResources;
+    std::unique_ptr<VulkanRenderer> m_renderer;
+    std::unique_ptr<Map> m_map;
+    std::unique_ptr<Camera> m_camera;
+};
+
+#endif //HEADLESSRUN_H
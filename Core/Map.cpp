@@ -6,11 +6,17 @@
 
 #include <cmath>
 
+namespace
+{
+    uint64_t nextRevision = 1;
+}
+
 Map::Map(uint16_t rows, uint16_t columns, uint16_t tileSize)
 {
     m_rows = rows;
     m_columns = columns;
     m_tileSize = tileSize;
+    m_revision = nextRevision++;
     m_tiles.resize(rows * columns, Tile{});
 
     for (size_t row = 0; row < rows; ++row)
@@ -82,6 +88,7 @@ void Map::setTileAt(uint16_t column, uint16_t row, uint8_t layer, size_t tileDat
     }
 
     auto& tile = getTileAt(column, row);
+    m_revision = nextRevision++;
 
     for (int i = 0; i < tile.tileLayers.size(); i++)
     {
@@ -5,6 +5,7 @@
 #ifndef MAP_H
 #define MAP_H
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -35,10 +36,16 @@ public:
     [[nodiscard]] size_t getColumns() const;
     void setTileAt(uint16_t column, uint16_t row, uint8_t layer, size_t tileDataIndex, size_t textureIndex, uint16_t frame);
 
+    /**
+     * Changes with every edit and is unique across maps, so copies with the same revision have the same tiles.
+     */
+    [[nodiscard]] uint64_t getRevision() const { return m_revision; }
+
 private:
     uint16_t m_rows = 0;
     uint16_t m_columns = 0;
     uint16_t m_tileSize = 1;
+    uint64_t m_revision = 0;
 
     std::vector<Tile> m_tiles;
 };
@@ -0,0 +1,91 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include "AssetManager.h"
+
+#include <algorithm>
+
+#include "../Core/TextureAtlasParser.h"
+
+AssetManager::AssetManager(std::filesystem::path assetsBasePath, uint32_t threadCount)
+    : m_assetsBasePath(std::move(assetsBasePath)), m_threadPool(threadCount)
+{
+}
+
+AssetHandle<DecodedImage> AssetManager::loadImage(const std::filesystem::path& path, TaskPriority priority)
+{
+    std::shared_ptr<AssetState<DecodedImage>> state;
+
+    {
+        std::lock_guard lock(m_imagesMutex);
+        auto& cached = m_images[path.generic_string()];
+        state = cached.lock();
+
+        if (state)
+        {
+            return AssetHandle(state);
+        }
+
+        state = std::make_shared<AssetState<DecodedImage>>();
+        cached = state;
+
+        if (m_images.size() >= m_imageSweepSize)
+        {
+            std::erase_if(m_images, [](const auto& image) { return image.second.expired(); });
+            m_imageSweepSize = std::max(MIN_IMAGE_SWEEP_SIZE, m_images.size() * 2);
+        }
+    }
+
+    run(decodeImage(m_assetsBasePath / path, priority), state);
+
+    return AssetHandle(state);
+}
+
+AssetHandle<LoadedAtlas> AssetManager::loadAtlas(const std::filesystem::path& path, TaskPriority priority)
+{
+    auto state = std::make_shared<AssetState<LoadedAtlas>>();
+    run(parseAtlas(m_assetsBasePath / path, priority), state);
+
+    return AssetHandle(state);
+}
+
+Task<DecodedImage> AssetManager::decodeImage(std::filesystem::path path, TaskPriority priority)
+{
+    co_await m_threadPool.schedule(priority);
+
+    const ImageInfo imageInfo = ImageLoader::loadImage(path);
+
+    co_return DecodedImage(
+        new ImageInfo(imageInfo),
+        [](const ImageInfo* image)
+        {
+            stbi_image_free(image->data);
+            delete image;
+        });
+}
+
+Task<LoadedAtlas> AssetManager::parseAtlas(std::filesystem::path path, TaskPriority priority)
+{
+    co_await m_threadPool.schedule(priority);
+
+    LoadedAtlas atlas{ TextureAtlasParser::parseAtlas(path), {} };
+
+    // Every image is requested before the first one is awaited, so they all decode in parallel
+    std::vector<AssetHandle<DecodedImage>> images{};
+    images.reserve(atlas.entries.size());
+
+    for (const auto& entry : atlas.entries)
+    {
+        images.push_back(loadImage(entry.filePath, priority));
+    }
+
+    atlas.images.reserve(images.size());
+
+    for (const auto& image : images)
+    {
+        atlas.images.push_back(co_await image);
+    }
+
+    co_return atlas;
+}
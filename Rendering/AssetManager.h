@@ -0,0 +1,198 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef ASSETMANAGER_H
+#define ASSETMANAGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ImageLoader.h"
+#include "Task.h"
+#include "ThreadPool.h"
+#include "../Core/TextureAtlasStructures.h"
+
+/**
+ * Decoded RGBA pixels, freed once the last reference is gone.
+ */
+typedef std::shared_ptr<const ImageInfo> DecodedImage;
+
+typedef struct
+{
+    std::vector<AtlasEntry> entries;
+    // Indexed like entries
+    std::vector<DecodedImage> images;
+} LoadedAtlas;
+
+/**
+ * Shared state of an asset that is still loading. Coroutines that await it are resumed by the thread that
+ * completes it.
+ */
+template<typename T>
+class AssetState
+{
+public:
+    [[nodiscard]] bool isReady() const { return m_ready.load(std::memory_order_acquire); }
+
+    void complete(T value)
+    {
+        m_value.emplace(std::move(value));
+        finish();
+    }
+
+    void fail(std::exception_ptr exception)
+    {
+        m_exception = std::move(exception);
+        finish();
+    }
+
+    const T& wait()
+    {
+        std::unique_lock lock(m_mutex);
+        m_condition.wait(lock, [this] { return isReady(); });
+
+        if (m_exception)
+        {
+            std::rethrow_exception(m_exception);
+        }
+
+        return *m_value;
+    }
+
+    /**
+     * Returns false when the asset finished in the meantime, the caller continues right away then.
+     */
+    bool addWaiter(std::coroutine_handle<> waiter)
+    {
+        std::lock_guard lock(m_mutex);
+
+        if (isReady())
+        {
+            return false;
+        }
+
+        m_waiters.push_back(waiter);
+        return true;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::atomic<bool> m_ready = false;
+    std::optional<T> m_value{};
+    std::exception_ptr m_exception{};
+    std::vector<std::coroutine_handle<>> m_waiters{};
+
+    void finish()
+    {
+        std::vector<std::coroutine_handle<>> waiters{};
+
+        {
+            std::lock_guard lock(m_mutex);
+            m_ready.store(true, std::memory_order_release);
+            waiters.swap(m_waiters);
+        }
+
+        m_condition.notify_all();
+
+        for (const auto waiter : waiters)
+        {
+            waiter.resume();
+        }
+    }
+};
+
+/**
+ * Handle to an asset that may still be loading. Can be polled, waited for on a plain thread or awaited in a task,
+ * which is how assets depend on each other.
+ */
+template<typename T>
+class AssetHandle
+{
+public:
+    AssetHandle() = default;
+    explicit AssetHandle(std::shared_ptr<AssetState<T>> state) : m_state(std::move(state)) {}
+
+    [[nodiscard]] bool isValid() const { return m_state != nullptr; }
+    [[nodiscard]] bool isReady() const { return m_state->isReady(); }
+
+    /**
+     * Blocks until the asset finished loading and rethrows the exception it failed with.
+     */
+    const T& get() const { return m_state->wait(); }
+
+    auto operator co_await() const noexcept
+    {
+        struct Awaiter
+        {
+            AssetState<T>& state;
+
+            bool await_ready() const { return state.isReady(); }
+            bool await_suspend(std::coroutine_handle<> handle) const { return state.addWaiter(handle); }
+            const T& await_resume() const { return state.wait(); }
+        };
+
+        return Awaiter{ *m_state };
+    }
+
+private:
+    std::shared_ptr<AssetState<T>> m_state;
+};
+
+/**
+ * Loads assets on a thread pool. Requests return a handle right away, the work runs as coroutine tasks that
+ * await the assets they depend on, so an atlas finishes once every image it references is decoded while the images
+ * decode in parallel. Images are shared between requests for the same file as long as a handle to them exists.
+ * GPU uploads stay with the caller, Vulkan queues are only used from the main thread.
+ */
+class AssetManager
+{
+public:
+    explicit AssetManager(std::filesystem::path assetsBasePath, uint32_t threadCount = 0);
+
+    /**
+     * path is relative to the assets base path, like the file paths of atlas entries.
+     */
+    AssetHandle<DecodedImage> loadImage(const std::filesystem::path& path, TaskPriority priority = TaskPriority::Normal);
+    AssetHandle<LoadedAtlas> loadAtlas(const std::filesystem::path& path, TaskPriority priority = TaskPriority::Normal);
+
+private:
+    static constexpr size_t MIN_IMAGE_SWEEP_SIZE = 64;
+
+    std::filesystem::path m_assetsBasePath;
+    std::mutex m_imagesMutex;
+    std::unordered_map<std::string, std::weak_ptr<AssetState<DecodedImage>>> m_images{};
+    // Expired images are swept once the map reaches this size, which keeps it within twice the live images
+    size_t m_imageSweepSize = MIN_IMAGE_SWEEP_SIZE;
+
+    // Declared last so the workers are joined before anything they use is destroyed
+    ThreadPool m_threadPool;
+
+    Task<DecodedImage> decodeImage(std::filesystem::path path, TaskPriority priority);
+    Task<LoadedAtlas> parseAtlas(std::filesystem::path path, TaskPriority priority);
+
+    template<typename T>
+    static DetachedTask run(Task<T> task, std::shared_ptr<AssetState<T>> state)
+    {
+        try
+        {
+            state->complete(co_await std::move(task));
+        }
+        catch (...)
+        {
+            state->fail(std::current_exception());
+        }
+    }
+};
+
+#endif //ASSETMANAGER_H
@@ -0,0 +1,258 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include "AtlasPacker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+    bool intersects(const PackRect& a, const PackRect& b)
+    {
+        return a.x < b.x + b.width && b.x < a.x + a.width &&
+               a.y < b.y + b.height && b.y < a.y + a.height;
+    }
+
+    bool contains(const PackRect& outer, const PackRect& inner)
+    {
+        return inner.x >= outer.x && inner.y >= outer.y &&
+               inner.x + inner.width <= outer.x + outer.width &&
+               inner.y + inner.height <= outer.y + outer.height;
+    }
+}
+
+MaxRectsPage::MaxRectsPage(uint32_t width, uint32_t height)
+{
+    m_width = width;
+    m_height = height;
+    m_freeRects.push_back({ 0, 0, width, height });
+}
+
+bool MaxRectsPage::tryInsert(uint32_t width, uint32_t height, PackRect& placed)
+{
+    uint32_t bestShortSide = std::numeric_limits<uint32_t>::max();
+    uint32_t bestLongSide = std::numeric_limits<uint32_t>::max();
+    bool found = false;
+
+    for (const auto& freeRect : m_freeRects)
+    {
+        if (freeRect.width < width || freeRect.height < height)
+        {
+            continue;
+        }
+
+        const uint32_t leftoverX = freeRect.width - width;
+        const uint32_t leftoverY = freeRect.height - height;
+        const uint32_t shortSide = std::min(leftoverX, leftoverY);
+        const uint32_t longSide = std::max(leftoverX, leftoverY);
+
+        if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide))
+        {
+            placed = { freeRect.x, freeRect.y, width, height };
+            bestShortSide = shortSide;
+            bestLongSide = longSide;
+            found = true;
+        }
+    }
+
+    if (!found)
+    {
+        return false;
+    }
+
+    pruneFreeRects(splitFreeRects(placed));
+
+    m_usedArea += static_cast<uint64_t>(width) * height;
+    m_usedHeight = std::max(m_usedHeight, placed.y + placed.height);
+
+    return true;
+}
+
+float MaxRectsPage::getOccupancy() const
+{
+    const uint32_t height = std::max<uint32_t>(m_usedHeight, 1);
+
+    return static_cast<float>(static_cast<double>(m_usedArea) / (static_cast<double>(m_width) * height));
+}
+
+size_t MaxRectsPage::splitFreeRects(const PackRect& placed)
+{
+    std::vector<PackRect> freeRects{};
+    std::vector<PackRect> splitRects{};
+    freeRects.reserve(m_freeRects.size() + 4);
+
+    for (const auto& freeRect : m_freeRects)
+    {
+        if (!intersects(freeRect, placed))
+        {
+            freeRects.push_back(freeRect);
+            continue;
+        }
+
+        // Up to four maximal rectangles remain around the placed one, one per side
+        if (placed.x > freeRect.x)
+        {
+            splitRects.push_back({ freeRect.x, freeRect.y, placed.x - freeRect.x, freeRect.height });
+        }
+
+        if (placed.x + placed.width < freeRect.x + freeRect.width)
+        {
+            const uint32_t x = placed.x + placed.width;
+            splitRects.push_back({ x, freeRect.y, freeRect.x + freeRect.width - x, freeRect.height });
+        }
+
+        if (placed.y > freeRect.y)
+        {
+            splitRects.push_back({ freeRect.x, freeRect.y, freeRect.width, placed.y - freeRect.y });
+        }
+
+        if (placed.y + placed.height < freeRect.y + freeRect.height)
+        {
+            const uint32_t y = placed.y + placed.height;
+            splitRects.push_back({ freeRect.x, y, freeRect.width, freeRect.y + freeRect.height - y });
+        }
+    }
+
+    const size_t firstSplitRect = freeRects.size();
+    freeRects.insert(freeRects.end(), splitRects.begin(), splitRects.end());
+    m_freeRects.swap(freeRects);
+
+    return firstSplitRect;
+}
+
+void MaxRectsPage::pruneFreeRects(size_t firstSplitRect)
+{
+    // Rectangles that did not intersect the placed one were maximal before and still are, only the new ones from
+    // splitting can lie inside another one
+    for (size_t i = firstSplitRect; i < m_freeRects.size();)
+    {
+        bool redundant = false;
+
+        for (size_t j = 0; j < m_freeRects.size() && !redundant; j++)
+        {
+            // Of two equal rectangles only the later one is removed
+            redundant = j != i &&
+                contains(m_freeRects[j], m_freeRects[i]) &&
+                (j < i || !contains(m_freeRects[i], m_freeRects[j]));
+        }
+
+        if (redundant)
+        {
+            m_freeRects.erase(m_freeRects.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
+AtlasPacker::AtlasPacker(uint32_t pageSize, uint32_t padding)
+{
+    m_pageSize = pageSize;
+    m_padding = padding;
+}
+
+AtlasPackResult AtlasPacker::pack(const std::vector<AtlasEntry>& entries) const
+{
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    typedef struct
+    {
+        size_t entry;
+        size_t frame;
+        uint32_t width;
+        uint32_t height;
+    } PackItem;
+
+    AtlasPackResult result{};
+    result.pageWidth = m_pageSize;
+    result.placements.resize(entries.size());
+
+    std::vector<PackItem> items{};
+
+    for (size_t entry = 0; entry < entries.size(); entry++)
+    {
+        const auto& frames = entries[entry].frames;
+        result.placements[entry].resize(frames.size());
+
+        for (size_t frame = 0; frame < frames.size(); frame++)
+        {
+            // The caller extrudes the frame's border texels into the padding, an empty frame has none
+            if (frames[frame].width == 0 || frames[frame].height == 0)
+            {
+                throw std::runtime_error("Atlas frame has a width or height of zero");
+            }
+
+            items.push_back({
+                entry,
+                frame,
+                static_cast<uint32_t>(frames[frame].width) + m_padding * 2,
+                static_cast<uint32_t>(frames[frame].height) + m_padding * 2
+            });
+        }
+    }
+
+    // Placing large frames first leaves the small ones to fill the gaps
+    std::sort(items.begin(), items.end(), [](const PackItem& a, const PackItem& b)
+    {
+        const uint32_t sideA = std::max(a.width, a.height);
+        const uint32_t sideB = std::max(b.width, b.height);
+
+        if (sideA != sideB)
+        {
+            return sideA > sideB;
+        }
+
+        return static_cast<uint64_t>(a.width) * a.height > static_cast<uint64_t>(b.width) * b.height;
+    });
+
+    std::vector<MaxRectsPage> pages{};
+
+    for (const auto& item : items)
+    {
+        if (item.width > m_pageSize || item.height > m_pageSize)
+        {
+            throw std::runtime_error("Atlas frame does not fit into an atlas page");
+        }
+
+        PackRect placed{};
+        size_t page = 0;
+
+        while (page < pages.size() && !pages[page].tryInsert(item.width, item.height, placed))
+        {
+            page++;
+        }
+
+        if (page == pages.size())
+        {
+            pages.emplace_back(m_pageSize, m_pageSize);
+            pages.back().tryInsert(item.width, item.height, placed);
+        }
+
+        result.placements[item.entry][item.frame] =
+        {
+            static_cast<uint32_t>(page),
+            placed.x + m_padding,
+            placed.y + m_padding,
+            item.width - m_padding * 2,
+            item.height - m_padding * 2
+        };
+    }
+
+    for (const auto& page : pages)
+    {
+        result.pageHeights.push_back(page.getUsedHeight());
+        result.pageOccupancy.push_back(page.getOccupancy());
+    }
+
+    result.frameCount = items.size();
+    result.packingMilliseconds = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+
+    return result;
+}
@@ -0,0 +1,90 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef ATLASPACKER_H
+#define ATLASPACKER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "../Core/TextureAtlasStructures.h"
+
+typedef struct
+{
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+} PackRect;
+
+typedef struct
+{
+    uint32_t page;
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+} AtlasPlacement;
+
+typedef struct
+{
+    // Indexed by entry, then by frame, positions exclude the padding around each frame
+    std::vector<std::vector<AtlasPlacement>> placements;
+    std::vector<uint32_t> pageHeights;
+    std::vector<float> pageOccupancy;
+    uint32_t pageWidth;
+    size_t frameCount;
+    double packingMilliseconds;
+} AtlasPackResult;
+
+/**
+ * One page of the atlas, packed with the MaxRects algorithm. The free space is kept as the list of maximal free
+ * rectangles, which may overlap. Rectangles are placed by best short side fit.
+ */
+class MaxRectsPage
+{
+public:
+    MaxRectsPage(uint32_t width, uint32_t height);
+
+    bool tryInsert(uint32_t width, uint32_t height, PackRect& placed);
+
+    /**
+     * Share of the page, cropped to the used height, that is covered by rectangles.
+     */
+    [[nodiscard]] float getOccupancy() const;
+
+    /**
+     * Bottom of the lowest placed rectangle, pages can be cropped to it.
+     */
+    [[nodiscard]] uint32_t getUsedHeight() const { return m_usedHeight; }
+
+private:
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+    uint32_t m_usedHeight = 0;
+    uint64_t m_usedArea = 0;
+    std::vector<PackRect> m_freeRects{};
+
+    size_t splitFreeRects(const PackRect& placed);
+    void pruneFreeRects(size_t firstSplitRect);
+};
+
+/**
+ * Packs the frames of atlas entries into as few square pages as possible, largest frames first.
+ * Every frame gets padding texels on each side that the caller fills by extruding the frame's border, so linear
+ * filtering at a frame edge never reads a neighbouring frame. Frames without area are rejected.
+ */
+class AtlasPacker
+{
+public:
+    explicit AtlasPacker(uint32_t pageSize, uint32_t padding = 1);
+
+    [[nodiscard]] AtlasPackResult pack(const std::vector<AtlasEntry>& entries) const;
+
+private:
+    uint32_t m_pageSize = 0;
+    uint32_t m_padding = 1;
+};
+
+#endif //ATLASPACKER_H
@@ -0,0 +1,143 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include "BindlessTextureTable.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+BindlessTextureTable::BindlessTextureTable(
+    VkPhysicalDevice physicalDevice,
+    VkDevice device,
+    const VkAllocationCallbacks* allocator,
+    const DeletionQueue& deletionQueue)
+    : m_deletionQueue(deletionQueue)
+{
+    m_device = device;
+    m_allocator = allocator;
+
+    VkPhysicalDeviceDescriptorIndexingProperties indexingProperties{
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES };
+    VkPhysicalDeviceProperties2 properties{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2 };
+    properties.pNext = &indexingProperties;
+    vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+
+    m_capacity = std::min({
+        MAX_CAPACITY,
+        indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages,
+        indexingProperties.maxDescriptorSetUpdateAfterBindSamplers,
+        indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+        indexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers });
+
+    VkDescriptorSetLayoutBinding textureBinding{};
+    textureBinding.binding = 0;
+    textureBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    textureBinding.descriptorCount = m_capacity;
+    textureBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    // Slots that were never written or whose texture is gone are fine as long as no draw indexes them
+    const VkDescriptorBindingFlags bindingFlags =
+        VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+        VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT |
+        VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{
+        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO };
+    bindingFlagsInfo.bindingCount = 1;
+    bindingFlagsInfo.pBindingFlags = &bindingFlags;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    layoutInfo.pNext = &bindingFlagsInfo;
+    layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    layoutInfo.bindingCount = 1;
+    layoutInfo.pBindings = &textureBinding;
+
+    if (vkCreateDescriptorSetLayout(m_device, &layoutInfo, m_allocator, &m_layout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create bindless texture set layout");
+    }
+
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSize.descriptorCount = m_capacity;
+
+    VkDescriptorPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+
+    if (vkCreateDescriptorPool(m_device, &poolInfo, m_allocator, &m_pool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create bindless texture descriptor pool");
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    allocInfo.descriptorPool = m_pool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &m_layout;
+
+    if (vkAllocateDescriptorSets(m_device, &allocInfo, &m_descriptorSet) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to allocate bindless texture set");
+    }
+}
+
+BindlessTextureTable::~BindlessTextureTable()
+{
+    vkDestroyDescriptorPool(m_device, m_pool, m_allocator);
+    vkDestroyDescriptorSetLayout(m_device, m_layout, m_allocator);
+}
+
+uint32_t BindlessTextureTable::add(VkImageView imageView, VkSampler sampler)
+{
+    uint32_t slot = m_nextSlot;
+
+    const auto reusable = std::find_if(m_freeSlots.begin(), m_freeSlots.end(), [this](const FreeSlot& freeSlot)
+    {
+        return freeSlot.reusableFrame <= m_deletionQueue.getFrameNumber();
+    });
+
+    if (reusable != m_freeSlots.end())
+    {
+        slot = reusable->slot;
+        m_freeSlots.erase(reusable);
+    }
+    else if (m_nextSlot < m_capacity)
+    {
+        m_nextSlot++;
+    }
+    else
+    {
+        throw std::runtime_error("Bindless texture table is full");
+    }
+
+    replace(slot, imageView, sampler);
+
+    return slot;
+}
+
+void BindlessTextureTable::replace(uint32_t slot, VkImageView imageView, VkSampler sampler) const
+{
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfo.imageView = imageView;
+    imageInfo.sampler = sampler;
+
+    VkWriteDescriptorSet write{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+    write.dstSet = m_descriptorSet;
+    write.dstBinding = 0;
+    write.dstArrayElement = slot;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.descriptorCount = 1;
+    write.pImageInfo = &imageInfo;
+
+    vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+}
+
+void BindlessTextureTable::remove(uint32_t slot)
+{
+    // Same rule as the deletion queue, frames recorded until then may still sample the old texture
+    m_freeSlots.push_back({ slot, m_deletionQueue.getFrameNumber() + m_deletionQueue.getFramesInFlight() });
+}
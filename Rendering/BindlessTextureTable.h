@@ -0,0 +1,69 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef BINDLESSTEXTURETABLE_H
+#define BINDLESSTEXTURETABLE_H
+
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "DeletionQueue.h"
+
+/**
+ * One descriptor set with a large array of combined image samplers that every pipeline indexes by slot.
+ * The array is partially bound and updatable after bind, so adding a texture writes exactly its own descriptor while
+ * the set stays bound, instead of reallocating and rewriting sets. A slot keeps its image until it is removed, an
+ * image that changes while frames may sample it moves to a new slot.
+ * Removed slots are reused once the frames in flight that may still sample them have finished.
+ */
+class BindlessTextureTable
+{
+public:
+    static constexpr uint32_t MAX_CAPACITY = 4096;
+
+    BindlessTextureTable(
+        VkPhysicalDevice physicalDevice,
+        VkDevice device,
+        const VkAllocationCallbacks* allocator,
+        const DeletionQueue& deletionQueue);
+    ~BindlessTextureTable();
+
+    uint32_t add(VkImageView imageView, VkSampler sampler);
+
+    /**
+     * Points slot at another image. The slot must not be used by a command buffer that is still pending.
+     */
+    void replace(uint32_t slot, VkImageView imageView, VkSampler sampler) const;
+
+    /**
+     * The slot must not be sampled by frames recorded afterward.
+     */
+    void remove(uint32_t slot);
+
+    [[nodiscard]] VkDescriptorSetLayout getLayout() const { return m_layout; }
+    [[nodiscard]] VkDescriptorSet getDescriptorSet() const { return m_descriptorSet; }
+    [[nodiscard]] uint32_t getCapacity() const { return m_capacity; }
+    [[nodiscard]] uint32_t getUsedSlots() const { return m_nextSlot - static_cast<uint32_t>(m_freeSlots.size()); }
+
+private:
+    typedef struct
+    {
+        uint32_t slot;
+        uint64_t reusableFrame;
+    } FreeSlot;
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    const VkAllocationCallbacks* m_allocator = nullptr;
+    const DeletionQueue& m_deletionQueue;
+
+    VkDescriptorSetLayout m_layout = VK_NULL_HANDLE;
+    VkDescriptorPool m_pool = VK_NULL_HANDLE;
+    VkDescriptorSet m_descriptorSet = VK_NULL_HANDLE;
+
+    uint32_t m_capacity = 0;
+    uint32_t m_nextSlot = 0;
+    std::vector<FreeSlot> m_freeSlots{};
+};
+
+#endif //BINDLESSTEXTURETABLE_H
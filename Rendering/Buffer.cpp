@@ -4,7 +4,8 @@
 
 #include "Buffer.h"
 
-#include "VulkanHelpers.h"
+#include <cstring>
+#include <stdexcept>
 
 Buffer::Buffer(
     const std::weak_ptr<VulkanResources> &resources,
@@ -28,34 +29,17 @@ Buffer::Buffer(
             throw std::runtime_error("Failed to create buffer");
         }
 
-        VkMemoryRequirements memRequirements;
-        vkGetBufferMemoryRequirements(ptr->m_logicalDevice, m_buffer, &memRequirements);
+        // Device local buffers that get written from the host can skip the staging copy on ReBAR capable devices
+        VkMemoryPropertyFlags preferredProperties = 0;
 
-        VkMemoryAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = VulkanHelpers::findMemoryType(
-            ptr->m_physicalDevice,
-            memRequirements.memoryTypeBits,
-            properties);
-
-        if (vkAllocateMemory(ptr->m_logicalDevice, &allocInfo, nullptr, &m_bufferMemory) != VK_SUCCESS)
+        if (!(properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) && (usage & VK_BUFFER_USAGE_TRANSFER_DST_BIT))
         {
-            throw std::runtime_error("Failed to allocate buffer memory");
+            preferredProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
         }
 
-        if (vkBindBufferMemory(ptr->m_logicalDevice, m_buffer, m_bufferMemory, 0) != VK_SUCCESS)
-        {
-            throw std::runtime_error("Failed to bind buffer memory");
-        }
-
-        if (!(m_properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
-        {
-            m_stagingBuffer = std::make_unique<Buffer>(
-                resources,
-                size,
-                VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-        }
+        m_allocation = ptr->m_memoryAllocator->allocateForBuffer(m_buffer, properties, preferredProperties);
+        m_properties = m_allocation.properties;
+        m_mappedMemory = m_allocation.mappedData;
     }
 }
 
@@ -63,106 +47,56 @@ Buffer::~Buffer()
 {
     if (const auto ptr = m_resources.lock())
     {
-        vkFreeMemory(ptr->m_logicalDevice, m_bufferMemory, ptr->m_allocator);
-        vkDestroyBuffer(ptr->m_logicalDevice, m_buffer, ptr->m_allocator);
+        ptr->m_bufferUploadQueue->cancel(m_buffer);
+        ptr->m_deletionQueue->destroyBuffer(m_buffer, m_allocation);
     }
 }
 
 void Buffer::clear() const
 {
-    void* mappedMemory = mapMemory(m_bufferSize);
-    memset(mappedMemory, 0, m_bufferSize);
-    unmapMemory();
+    if (isHostVisible())
+    {
+        memset(m_mappedMemory, 0, m_bufferSize);
+        flush(0, m_bufferSize);
+    }
+    else if (const auto ptr = m_resources.lock())
+    {
+        ptr->m_bufferUploadQueue->clear(m_buffer);
+    }
 }
 
-
-void Buffer::writeData(const void *data, VkDeviceSize length) const
+void Buffer::writeData(const void *data, VkDeviceSize length, VkDeviceSize offset) const
 {
     if (length == 0)
     {
         return;
     }
 
-    if (m_properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    if (offset + length > m_bufferSize)
     {
-        void* mappedMemory = mapMemory(length);
-        memcpy(mappedMemory, data, length);
-        unmapMemory();
+        throw std::runtime_error("Buffer write exceeds buffer size");
     }
-    else if (const auto ptr = m_resources.lock())
-    {
-        const Buffer& stagingBuffer = *m_stagingBuffer;
-        stagingBuffer.writeData(data, length);
-
-        VkCommandBufferAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
-        allocInfo.commandPool = ptr->m_commandPool;
-        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocInfo.commandBufferCount = 1;
-
-        VkCommandBuffer cmdBuffer;
-        vkAllocateCommandBuffers(ptr->m_logicalDevice, &allocInfo, &cmdBuffer);
-
-        VkCommandBufferBeginInfo beginInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
-        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-        vkBeginCommandBuffer(cmdBuffer, &beginInfo);
 
-        VkBufferCopy copyRegion{};
-        copyRegion.srcOffset = 0;
-        copyRegion.dstOffset = 0;
-        copyRegion.size = length;
-
-        vkCmdCopyBuffer(cmdBuffer, stagingBuffer.getBuffer(), m_buffer, 1, &copyRegion);
-        vkEndCommandBuffer(cmdBuffer);
-
-        VkSubmitInfo submitInfo{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &cmdBuffer;
-
-        vkQueueSubmit(ptr->m_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-        vkQueueWaitIdle(ptr->m_graphicsQueue);
-    }
-}
-
-void* Buffer::mapMemory(VkDeviceSize length) const
-{
-    void* mappedMemory = nullptr;
-
-    if (m_resources.expired())
+    if (isHostVisible())
     {
-        return mappedMemory;
+        memcpy(static_cast<char*>(m_mappedMemory) + offset, data, length);
+        flush(offset, length);
     }
-
-    if (const auto ptr = m_resources.lock())
+    else if (const auto ptr = m_resources.lock())
     {
-        const VkResult result = vkMapMemory(
-            ptr->m_logicalDevice,
-            m_bufferMemory,
-            0,
-            length,
-            0,
-            &mappedMemory);
-
-        if (result != VK_SUCCESS)
-        {
-            throw std::runtime_error("Failed to map memory");
-        }
+        ptr->m_bufferUploadQueue->write(m_buffer, offset, data, length);
     }
-
-    return mappedMemory;
 }
 
-void Buffer::unmapMemory() const
+void Buffer::flush(VkDeviceSize offset, VkDeviceSize length) const
 {
-    if (m_resources.expired())
+    if (!m_mappedMemory || (m_properties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
     {
         return;
     }
 
     if (const auto ptr = m_resources.lock())
     {
-        vkUnmapMemory(ptr->m_logicalDevice, m_bufferMemory);
+        ptr->m_memoryAllocator->flush(m_allocation, offset, length);
     }
 }
-
-
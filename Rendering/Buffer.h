@@ -10,6 +10,13 @@
 #include "VulkanResources.h"
 #include  "vulkan/vulkan.h"
 
+/**
+ * Host visible buffers stay mapped for their whole lifetime, so writes are plain memcpy calls followed by a flush
+ * of the written range for non-coherent memory. Buffers requested as device local that are also meant to be written
+ * to (TRANSFER_DST usage) prefer device local and host visible memory (ReBAR) and skip the staging copy where
+ * the device offers such a memory type. Writes to other device local buffers go through the BufferUploadQueue and
+ * land with the next frame. Memory is sub-allocated from the MemoryAllocator of the VulkanResources.
+ */
 class Buffer
 {
 public:
@@ -21,22 +28,36 @@ public:
     ~Buffer();
 
     [[nodiscard]] VkBuffer getBuffer() const { return m_buffer; }
-    [[nodiscard]] VkDeviceMemory getBufferMemory() const { return m_bufferMemory; }
+    [[nodiscard]] VkDeviceMemory getBufferMemory() const { return m_allocation.memory; }
+    [[nodiscard]] const MemoryAllocation& getAllocation() const { return m_allocation; }
     [[nodiscard]] VkDeviceSize getSize() const { return m_bufferSize;}
-
-    [[nodiscard]] void* mapMemory(VkDeviceSize length) const;
-    void unmapMemory() const;
-
+    [[nodiscard]] VkMemoryPropertyFlags getMemoryProperties() const { return m_properties; }
+    [[nodiscard]] void* getMappedMemory() const { return m_mappedMemory; }
+
+    [[nodiscard]] bool isHostVisible() const
+    {
+        return m_properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+    }
+
+    /**
+     * Device local buffers that are not host visible are written by the command buffer of the next frame, commands
+     * recorded before it must not read the new contents.
+     */
     void clear() const;
-    void writeData(const void* data, VkDeviceSize length) const;
+    void writeData(const void* data, VkDeviceSize length, VkDeviceSize offset = 0) const;
+
+    /**
+     * Makes host writes to the given range visible to the device. No-op for host coherent memory.
+     */
+    void flush(VkDeviceSize offset = 0, VkDeviceSize length = VK_WHOLE_SIZE) const;
 
 private:
     std::weak_ptr<VulkanResources> m_resources;
     VkBuffer m_buffer = VK_NULL_HANDLE;
-    VkDeviceMemory m_bufferMemory = VK_NULL_HANDLE;
+    MemoryAllocation m_allocation{};
     VkDeviceSize m_bufferSize = 0;
     VkMemoryPropertyFlags m_properties;
-    std::unique_ptr<Buffer> m_stagingBuffer;
+    void* m_mappedMemory = nullptr;
 };
 
 #endif //BUFFER_H
@@ -0,0 +1,144 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include "BufferUploadQueue.h"
+
+#include <cstring>
+
+#include "UploadRing.h"
+#include "VulkanHelpers.h"
+
+void BufferUploadQueue::write(VkBuffer buffer, VkDeviceSize offset, const void* data, VkDeviceSize length)
+{
+    const VkDeviceSize stagingOffset = VulkanHelpers::alignUp(m_stagedBytes.size(), UPLOAD_ALIGNMENT);
+
+    m_stagedBytes.resize(stagingOffset + length);
+    memcpy(m_stagedBytes.data() + stagingOffset, data, length);
+
+    m_uploads.push_back({ buffer, offset, length, stagingOffset, false });
+}
+
+void BufferUploadQueue::clear(VkBuffer buffer)
+{
+    m_uploads.push_back({ buffer, 0, VK_WHOLE_SIZE, 0, true });
+}
+
+void BufferUploadQueue::cancel(VkBuffer buffer)
+{
+    std::erase_if(m_uploads, [buffer](const PendingUpload& upload) { return upload.buffer == buffer; });
+}
+
+void BufferUploadQueue::record(
+    VkCommandBuffer commandBuffer,
+    UploadRing& uploadRing,
+    std::vector<VkBufferMemoryBarrier>& barriers)
+{
+    if (m_uploads.empty())
+    {
+        m_stagedBytes.clear();
+        return;
+    }
+
+    // The buffers are written in place, so the copies wait for the frames still reading them
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+        VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0,
+        0,
+        nullptr,
+        0,
+        nullptr,
+        0,
+        nullptr);
+
+    UploadAllocation staging{};
+
+    if (!m_stagedBytes.empty())
+    {
+        staging = uploadRing.upload(m_stagedBytes.data(), m_stagedBytes.size(), UPLOAD_ALIGNMENT);
+    }
+
+    size_t firstUnordered = 0;
+
+    for (size_t i = 0; i < m_uploads.size(); i++)
+    {
+        const PendingUpload& upload = m_uploads[i];
+
+        // Transfers are not ordered among each other, a later write to the same range waits for the earlier ones
+        for (size_t earlier = firstUnordered; earlier < i; earlier++)
+        {
+            if (!overlaps(m_uploads[earlier], upload))
+            {
+                continue;
+            }
+
+            VkMemoryBarrier barrier{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+            vkCmdPipelineBarrier(
+                commandBuffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                0,
+                1,
+                &barrier,
+                0,
+                nullptr,
+                0,
+                nullptr);
+
+            firstUnordered = i;
+            break;
+        }
+
+        if (upload.clear)
+        {
+            vkCmdFillBuffer(commandBuffer, upload.buffer, 0, VK_WHOLE_SIZE, 0);
+        }
+        else
+        {
+            VkBufferCopy copyRegion{};
+            copyRegion.srcOffset = staging.offset + upload.stagingOffset;
+            copyRegion.dstOffset = upload.offset;
+            copyRegion.size = upload.size;
+
+            vkCmdCopyBuffer(commandBuffer, staging.buffer, upload.buffer, 1, &copyRegion);
+        }
+
+        VkBufferMemoryBarrier barrier{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask =
+            VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT |
+            VK_ACCESS_INDEX_READ_BIT |
+            VK_ACCESS_UNIFORM_READ_BIT |
+            VK_ACCESS_SHADER_READ_BIT;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = upload.buffer;
+        barrier.offset = upload.offset;
+        barrier.size = upload.size;
+        barriers.push_back(barrier);
+    }
+
+    m_uploads.clear();
+    m_stagedBytes.clear();
+}
+
+bool BufferUploadQueue::overlaps(const PendingUpload& first, const PendingUpload& second)
+{
+    if (first.buffer != second.buffer)
+    {
+        return false;
+    }
+
+    const VkDeviceSize firstEnd = first.size == VK_WHOLE_SIZE ? VK_WHOLE_SIZE : first.offset + first.size;
+    const VkDeviceSize secondEnd = second.size == VK_WHOLE_SIZE ? VK_WHOLE_SIZE : second.offset + second.size;
+
+    return first.offset < secondEnd && second.offset < firstEnd;
+}
@@ -0,0 +1,61 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef BUFFERUPLOADQUEUE_H
+#define BUFFERUPLOADQUEUE_H
+
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+class UploadRing;
+
+/**
+ * Collects writes to device local buffers that are not host visible and records them into the command buffer of the
+ * next frame, staged through the upload ring, instead of a submit and a queue wait per write.
+ * Written buffers may still be read by frames in flight, the copies wait for them on the GPU. The written data is
+ * only visible to commands recorded after record, the barriers for that are appended to the frame's upload barriers.
+ */
+class BufferUploadQueue
+{
+public:
+    /**
+     * Copies length bytes of data, they are written to buffer at offset by the next record.
+     */
+    void write(VkBuffer buffer, VkDeviceSize offset, const void* data, VkDeviceSize length);
+
+    /**
+     * Fills the whole buffer with zeros in the next record.
+     */
+    void clear(VkBuffer buffer);
+
+    /**
+     * Drops the pending writes to buffer, for buffers destroyed before the next frame.
+     */
+    void cancel(VkBuffer buffer);
+
+    void record(VkCommandBuffer commandBuffer, UploadRing& uploadRing, std::vector<VkBufferMemoryBarrier>& barriers);
+
+    [[nodiscard]] bool isEmpty() const { return m_uploads.empty(); }
+
+private:
+    typedef struct
+    {
+        VkBuffer buffer;
+        VkDeviceSize offset;
+        // VK_WHOLE_SIZE for clears
+        VkDeviceSize size;
+        VkDeviceSize stagingOffset;
+        bool clear;
+    } PendingUpload;
+
+    static constexpr VkDeviceSize UPLOAD_ALIGNMENT = 16;
+
+    std::vector<PendingUpload> m_uploads{};
+    std::vector<uint8_t> m_stagedBytes{};
+
+    [[nodiscard]] static bool overlaps(const PendingUpload& first, const PendingUpload& second);
+};
+
+#endif //BUFFERUPLOADQUEUE_H
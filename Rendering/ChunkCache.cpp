@@ -0,0 +1,557 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include "ChunkCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Shader.h"
+
+ChunkCache::ChunkCache(
+    const std::weak_ptr<VulkanResources>& resources,
+    const std::filesystem::path& vertexShaderPath,
+    const std::filesystem::path& fragmentShaderPath,
+    VkFormat colorFormat,
+    uint32_t chunkSize,
+    VkDeviceSize budgetBytes,
+    uint32_t maxChunks)
+{
+    m_resources = resources;
+    m_colorFormat = colorFormat;
+    m_chunkSize = std::max<uint32_t>(chunkSize, 1);
+    m_statistics.budgetBytes = budgetBytes;
+    m_statistics.maxChunks = std::max<uint32_t>(maxChunks, 1);
+
+    const auto ptr = resources.lock();
+
+    if (!ptr)
+    {
+        return;
+    }
+
+    initializeSampler(ptr->m_logicalDevice, ptr->m_allocator);
+    initializeDescriptorSetLayout(ptr->m_logicalDevice, ptr->m_allocator);
+    initializeDescriptorPool(ptr->m_logicalDevice, ptr->m_allocator, ptr->m_frameRing->getFramesInFlight());
+    initializePipelineLayout(ptr->m_logicalDevice, ptr->m_allocator);
+
+    const Shader shader(ptr->m_logicalDevice, vertexShaderPath, fragmentShaderPath);
+    m_pipeline = std::make_unique<Pipeline>(resources, shader, colorFormat, 0, false, m_pipelineLayout);
+}
+
+ChunkCache::~ChunkCache()
+{
+    const auto ptr = m_resources.lock();
+
+    if (!ptr)
+    {
+        return;
+    }
+
+    clear();
+    m_pipeline.reset();
+    ptr->m_deletionQueue->destroySampler(m_sampler);
+    // Enqueued after the descriptor sets of the chunks, so the pool outlives them
+    ptr->m_deletionQueue->destroyDescriptorPool(m_descriptorPool);
+
+    vkDestroyPipelineLayout(ptr->m_logicalDevice, m_pipelineLayout, ptr->m_allocator);
+    vkDestroyDescriptorSetLayout(ptr->m_logicalDevice, m_descriptorSetLayout, ptr->m_allocator);
+}
+
+void ChunkCache::initializeSampler(VkDevice device, const VkAllocationCallbacks* allocator)
+{
+    // Chunks are drawn at one texel per pixel, clamping keeps neighbouring chunk edges from bleeding in
+    VkSamplerCreateInfo samplerInfo{ VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO };
+    samplerInfo.magFilter = VK_FILTER_NEAREST;
+    samplerInfo.minFilter = VK_FILTER_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.maxLod = 0.0f;
+
+    if (vkCreateSampler(device, &samplerInfo, allocator, &m_sampler) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create chunk sampler!");
+    }
+}
+
+void ChunkCache::initializeDescriptorSetLayout(VkDevice device, const VkAllocationCallbacks* allocator)
+{
+    VkDescriptorSetLayoutBinding chunkBinding{};
+    chunkBinding.binding = 0;
+    chunkBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    chunkBinding.descriptorCount = 1;
+    chunkBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutCreateInfo createInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    createInfo.bindingCount = 1;
+    createInfo.pBindings = &chunkBinding;
+
+    if (vkCreateDescriptorSetLayout(device, &createInfo, allocator, &m_descriptorSetLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create chunk descriptor set layout");
+    }
+}
+
+void ChunkCache::initializeDescriptorPool(
+    VkDevice device,
+    const VkAllocationCallbacks* allocator,
+    uint32_t framesInFlight)
+{
+    // A frame frees at most the chunks resident at its start, their sets wait in the deletion queue for the frames
+    // in flight while the same number of new chunks may be resident
+    const auto setCount = static_cast<uint32_t>(m_statistics.maxChunks * (framesInFlight + 1));
+
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSize.descriptorCount = setCount;
+
+    VkDescriptorPoolCreateInfo createInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    createInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+    createInfo.maxSets = setCount;
+    createInfo.poolSizeCount = 1;
+    createInfo.pPoolSizes = &poolSize;
+
+    if (vkCreateDescriptorPool(device, &createInfo, allocator, &m_descriptorPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create chunk descriptor pool");
+    }
+}
+
+void ChunkCache::initializePipelineLayout(VkDevice device, const VkAllocationCallbacks* allocator)
+{
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(ChunkParameters);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &m_descriptorSetLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, allocator, &m_pipelineLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create chunk pipeline layout");
+    }
+}
+
+void ChunkCache::invalidate(const TilemapRenderer& tilemap)
+{
+    if (tilemap.haveAllTilesChanged())
+    {
+        invalidateAll();
+        return;
+    }
+
+    const uint32_t columns = std::max<uint32_t>(tilemap.getColumns(), 1);
+
+    for (const uint32_t tile : tilemap.getChangedTiles())
+    {
+        const uint32_t column = tile % columns;
+        const uint32_t row = tile / columns;
+        const auto chunk = m_chunks.find(getKey(column / m_chunkSize, row / m_chunkSize));
+
+        if (chunk != m_chunks.end())
+        {
+            chunk->second.dirty = true;
+        }
+    }
+}
+
+void ChunkCache::invalidateAll()
+{
+    for (auto& [key, chunk] : m_chunks)
+    {
+        chunk.dirty = true;
+    }
+}
+
+bool ChunkCache::prepare(
+    VkCommandBuffer commandBuffer,
+    const Camera::CameraFrustum& frustum,
+    uint32_t pixelsPerUnit,
+    const TilemapRenderer& tilemap,
+    VkDescriptorSet sceneDescriptorSet,
+    uint32_t indexCount)
+{
+    m_frame++;
+    m_visibleChunks.clear();
+    m_chunksToRender.clear();
+
+    const auto ptr = m_resources.lock();
+
+    if (!ptr || sceneDescriptorSet == VK_NULL_HANDLE)
+    {
+        return false;
+    }
+
+    // Zooming changes the resolution of every chunk, the images are recreated at the new size on demand
+    if (pixelsPerUnit != m_pixelsPerUnit)
+    {
+        clear();
+        m_pixelsPerUnit = pixelsPerUnit;
+        m_chunkPixels = std::clamp<uint32_t>(
+            m_chunkSize * pixelsPerUnit,
+            1,
+            ptr->m_physicalDeviceProperties.limits.maxImageDimension2D);
+    }
+
+    if (tilemap.getLayerCount() == 0)
+    {
+        return true;
+    }
+
+    const auto chunkColumns = static_cast<int64_t>((tilemap.getColumns() + m_chunkSize - 1) / m_chunkSize);
+    const auto chunkRows = static_cast<int64_t>((tilemap.getRows() + m_chunkSize - 1) / m_chunkSize);
+    const auto chunkSize = static_cast<float>(m_chunkSize);
+
+    const int64_t firstX = std::max<int64_t>(static_cast<int64_t>(std::floor(frustum.x / chunkSize)), 0);
+    const int64_t firstY = std::max<int64_t>(static_cast<int64_t>(std::floor(frustum.y / chunkSize)), 0);
+    const int64_t lastX = std::min<int64_t>(static_cast<int64_t>(std::floor(frustum.toX / chunkSize)), chunkColumns - 1);
+    const int64_t lastY = std::min<int64_t>(static_cast<int64_t>(std::floor(frustum.toY / chunkSize)), chunkRows - 1);
+
+    const VkDeviceSize chunkBytes = static_cast<VkDeviceSize>(m_chunkPixels) * m_chunkPixels * 4;
+
+    for (int64_t y = firstY; y <= lastY; y++)
+    {
+        for (int64_t x = firstX; x <= lastX; x++)
+        {
+            const auto chunkX = static_cast<uint32_t>(x);
+            const auto chunkY = static_cast<uint32_t>(y);
+            CachedChunk* chunk = nullptr;
+
+            if (const auto existing = m_chunks.find(getKey(chunkX, chunkY)); existing != m_chunks.end())
+            {
+                chunk = &existing->second;
+            }
+            else
+            {
+                if (!evictLeastRecentlyUsed(chunkBytes))
+                {
+                    // Visible chunks alone exceed the budget, missing ones are rendered once it allows them
+                    renderChunks(commandBuffer, tilemap, sceneDescriptorSet, indexCount);
+                    m_visibleChunks.clear();
+                    return false;
+                }
+
+                chunk = createChunk(*ptr, chunkX, chunkY);
+            }
+
+            markUsed(*chunk);
+
+            if (chunk->dirty)
+            {
+                m_statistics.misses++;
+                m_chunksToRender.push_back(chunk);
+            }
+            else
+            {
+                m_statistics.hits++;
+            }
+
+            m_visibleChunks.push_back(chunk);
+        }
+    }
+
+    renderChunks(commandBuffer, tilemap, sceneDescriptorSet, indexCount);
+
+    return true;
+}
+
+void ChunkCache::record(VkCommandBuffer commandBuffer, const glm::mat4& viewProjection, uint32_t indexCount) const
+{
+    if (m_visibleChunks.empty())
+    {
+        return;
+    }
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline->getPipeline());
+
+    const auto chunkSize = static_cast<float>(m_chunkSize);
+
+    for (const CachedChunk* chunk : m_visibleChunks)
+    {
+        vkCmdBindDescriptorSets(
+            commandBuffer,
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            m_pipelineLayout,
+            0,
+            1,
+            &chunk->descriptorSet,
+            0,
+            nullptr);
+
+        const ChunkParameters parameters
+        {
+            viewProjection,
+            glm::vec4(
+                static_cast<float>(chunk->chunkX) * chunkSize,
+                static_cast<float>(chunk->chunkY) * chunkSize,
+                chunkSize,
+                chunkSize)
+        };
+
+        vkCmdPushConstants(
+            commandBuffer,
+            m_pipelineLayout,
+            VK_SHADER_STAGE_VERTEX_BIT,
+            0,
+            sizeof(ChunkParameters),
+            &parameters);
+
+        vkCmdDrawIndexed(commandBuffer, indexCount, 1, 0, 0, 0);
+    }
+}
+
+ChunkCache::CachedChunk* ChunkCache::createChunk(VulkanResources& resources, uint32_t chunkX, uint32_t chunkY)
+{
+    CachedChunk chunk{};
+    chunk.chunkX = chunkX;
+    chunk.chunkY = chunkY;
+    chunk.dirty = true;
+
+    // Same format as the swapchain, so the tilemap pipeline can render into it
+    VkImageCreateInfo imageInfo{ VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent.width = m_chunkPixels;
+    imageInfo.extent.height = m_chunkPixels;
+    imageInfo.extent.depth = 1;
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = m_colorFormat;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+
+    if (vkCreateImage(resources.m_logicalDevice, &imageInfo, resources.m_allocator, &chunk.image) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create chunk image!");
+    }
+
+    chunk.allocation = resources.m_memoryAllocator->allocateForImage(chunk.image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    chunk.bytes = chunk.allocation.size;
+
+    VkImageViewCreateInfo viewInfo{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+    viewInfo.image = chunk.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = m_colorFormat;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    if (vkCreateImageView(resources.m_logicalDevice, &viewInfo, resources.m_allocator, &chunk.imageView) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create chunk image view!");
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    allocInfo.descriptorPool = m_descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &m_descriptorSetLayout;
+
+    if (vkAllocateDescriptorSets(resources.m_logicalDevice, &allocInfo, &chunk.descriptorSet) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to allocate chunk descriptor set!");
+    }
+
+    VkDescriptorImageInfo imageDescriptor{};
+    imageDescriptor.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageDescriptor.imageView = chunk.imageView;
+    imageDescriptor.sampler = m_sampler;
+
+    VkWriteDescriptorSet descriptorWrite{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+    descriptorWrite.dstSet = chunk.descriptorSet;
+    descriptorWrite.dstBinding = 0;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pImageInfo = &imageDescriptor;
+
+    vkUpdateDescriptorSets(resources.m_logicalDevice, 1, &descriptorWrite, 0, nullptr);
+
+    m_statistics.residentBytes += chunk.bytes;
+    m_statistics.residentChunks++;
+
+    const uint64_t key = getKey(chunkX, chunkY);
+    chunk.usePosition = m_leastRecentlyUsed.insert(m_leastRecentlyUsed.end(), key);
+
+    return &m_chunks.emplace(key, chunk).first->second;
+}
+
+void ChunkCache::markUsed(CachedChunk& chunk)
+{
+    chunk.lastUsedFrame = m_frame;
+    m_leastRecentlyUsed.splice(m_leastRecentlyUsed.end(), m_leastRecentlyUsed, chunk.usePosition);
+}
+
+bool ChunkCache::evictLeastRecentlyUsed(VkDeviceSize requiredBytes)
+{
+    while (m_statistics.residentBytes + requiredBytes > m_statistics.budgetBytes ||
+        m_statistics.residentChunks + 1 > m_statistics.maxChunks)
+    {
+        if (m_leastRecentlyUsed.empty())
+        {
+            return false;
+        }
+
+        const auto leastRecentlyUsed = m_chunks.find(m_leastRecentlyUsed.front());
+
+        // Chunks used in this frame are at the back, once the front is one of them all resident chunks are visible
+        if (leastRecentlyUsed->second.lastUsedFrame == m_frame)
+        {
+            return false;
+        }
+
+        destroyChunk(leastRecentlyUsed->second);
+        m_chunks.erase(leastRecentlyUsed);
+        m_statistics.evictions++;
+    }
+
+    return true;
+}
+
+void ChunkCache::destroyChunk(const CachedChunk& chunk)
+{
+    m_leastRecentlyUsed.erase(chunk.usePosition);
+    m_statistics.residentBytes -= chunk.bytes;
+    m_statistics.residentChunks--;
+
+    const auto ptr = m_resources.lock();
+
+    if (!ptr)
+    {
+        return;
+    }
+
+    // Frames in flight may still sample the chunk
+    ptr->m_deletionQueue->freeDescriptorSet(m_descriptorPool, chunk.descriptorSet);
+    ptr->m_deletionQueue->destroyImageView(chunk.imageView);
+    ptr->m_deletionQueue->destroyImage(chunk.image, chunk.allocation);
+}
+
+void ChunkCache::clear()
+{
+    for (const auto& [key, chunk] : m_chunks)
+    {
+        destroyChunk(chunk);
+    }
+
+    m_chunks.clear();
+    m_visibleChunks.clear();
+    m_chunksToRender.clear();
+}
+
+void ChunkCache::renderChunks(
+    VkCommandBuffer commandBuffer,
+    const TilemapRenderer& tilemap,
+    VkDescriptorSet sceneDescriptorSet,
+    uint32_t indexCount)
+{
+    if (m_chunksToRender.empty())
+    {
+        return;
+    }
+
+    std::vector<VkImageMemoryBarrier> barriers(m_chunksToRender.size());
+
+    for (size_t i = 0; i < m_chunksToRender.size(); i++)
+    {
+        // The previous contents are cleared anyway, the barrier only has to wait for earlier frames sampling it
+        VkImageMemoryBarrier& barrier = barriers[i];
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_NONE;
+        barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = m_chunksToRender[i]->image;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.layerCount = 1;
+    }
+
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        0,
+        0,
+        nullptr,
+        0,
+        nullptr,
+        static_cast<uint32_t>(barriers.size()),
+        barriers.data());
+
+    const auto chunkSize = static_cast<float>(m_chunkSize);
+
+    for (CachedChunk* chunk : m_chunksToRender)
+    {
+        VkRenderingAttachmentInfo colorAttachment{ VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO };
+        colorAttachment.imageView = chunk->imageView;
+        colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        colorAttachment.clearValue.color = { { 0.0f, 0.0f, 0.0f, 0.0f } };
+
+        VkRenderingInfo renderingInfo{ VK_STRUCTURE_TYPE_RENDERING_INFO };
+        renderingInfo.renderArea = { { 0, 0 }, { m_chunkPixels, m_chunkPixels } };
+        renderingInfo.layerCount = 1;
+        renderingInfo.colorAttachmentCount = 1;
+        renderingInfo.pColorAttachments = &colorAttachment;
+
+        vkCmdBeginRendering(commandBuffer, &renderingInfo);
+
+        const VkViewport viewport = {
+            0,
+            0,
+            static_cast<float>(m_chunkPixels),
+            static_cast<float>(m_chunkPixels),
+            0,
+            1
+        };
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+        const VkRect2D scissor = { { 0, 0 }, { m_chunkPixels, m_chunkPixels } };
+        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+        const float left = static_cast<float>(chunk->chunkX) * chunkSize;
+        const float bottom = static_cast<float>(chunk->chunkY) * chunkSize;
+        const glm::mat4 projection = glm::ortho(left, left + chunkSize, bottom, bottom + chunkSize);
+
+        tilemap.record(commandBuffer, sceneDescriptorSet, indexCount, projection);
+
+        vkCmdEndRendering(commandBuffer);
+
+        chunk->dirty = false;
+    }
+
+    for (auto& barrier : barriers)
+    {
+        barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    }
+
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        0,
+        0,
+        nullptr,
+        0,
+        nullptr,
+        static_cast<uint32_t>(barriers.size()),
+        barriers.data());
+
+    m_chunksToRender.clear();
+}
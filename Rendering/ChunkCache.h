@@ -0,0 +1,153 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef CHUNKCACHE_H
+#define CHUNKCACHE_H
+
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+#include "MemoryAllocator.h"
+#include "Pipeline.h"
+#include "TilemapRenderer.h"
+#include "VulkanResources.h"
+#include "../Core/Camera.h"
+
+typedef struct
+{
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    size_t residentChunks;
+    size_t maxChunks;
+    VkDeviceSize residentBytes;
+    VkDeviceSize budgetBytes;
+} ChunkCacheStatistics;
+
+/**
+ * Keeps square chunks of the tilemap rendered into offscreen images, so frames composite one quad per visible chunk
+ * instead of resolving every tile of every layer per pixel.
+ * A chunk is rendered again when one of its tiles changed or the pixels per unit changed. Chunks that are not visible
+ * are evicted least recently used first once the resident images would exceed the byte budget or the chunk count.
+ * The chunk descriptor sets come from a pool of the cache, sized by the chunk count.
+ */
+class ChunkCache
+{
+public:
+    static constexpr uint32_t DEFAULT_CHUNK_SIZE = 16;
+    static constexpr VkDeviceSize DEFAULT_BUDGET = 128 * 1024 * 1024;
+    static constexpr uint32_t DEFAULT_MAX_CHUNKS = 1024;
+
+    ChunkCache(
+        const std::weak_ptr<VulkanResources>& resources,
+        const std::filesystem::path& vertexShaderPath,
+        const std::filesystem::path& fragmentShaderPath,
+        VkFormat colorFormat,
+        uint32_t chunkSize = DEFAULT_CHUNK_SIZE,
+        VkDeviceSize budgetBytes = DEFAULT_BUDGET,
+        uint32_t maxChunks = DEFAULT_MAX_CHUNKS);
+    ~ChunkCache();
+
+    /**
+     * Marks the chunks dirty whose tiles changed in the last update of tilemap.
+     */
+    void invalidate(const TilemapRenderer& tilemap);
+
+    /**
+     * Marks every chunk dirty, for changes that are not tied to tiles, like a texture of the map becoming resident.
+     */
+    void invalidateAll();
+
+    /**
+     * Renders the visible chunks that are missing or dirty. Has to be recorded outside of a render pass and expects
+     * the default quad to be bound. Returns false when the visible chunks do not fit into the budget, the tilemap
+     * has to be drawn directly for this frame then.
+     */
+    bool prepare(
+        VkCommandBuffer commandBuffer,
+        const Camera::CameraFrustum& frustum,
+        uint32_t pixelsPerUnit,
+        const TilemapRenderer& tilemap,
+        VkDescriptorSet sceneDescriptorSet,
+        uint32_t indexCount);
+
+    /**
+     * Draws the chunks of the last prepare. Expects the default quad to be bound.
+     */
+    void record(VkCommandBuffer commandBuffer, const glm::mat4& viewProjection, uint32_t indexCount) const;
+
+    void setBudget(VkDeviceSize budgetBytes) { m_statistics.budgetBytes = budgetBytes; }
+    [[nodiscard]] const ChunkCacheStatistics& getStatistics() const { return m_statistics; }
+
+private:
+    typedef struct
+    {
+        glm::mat4 viewProjection;
+        glm::vec4 rect;
+    } ChunkParameters;
+
+    typedef struct
+    {
+        uint32_t chunkX;
+        uint32_t chunkY;
+        VkImage image;
+        VkImageView imageView;
+        MemoryAllocation allocation;
+        VkDescriptorSet descriptorSet;
+        VkDeviceSize bytes;
+        uint64_t lastUsedFrame;
+        // Position in m_leastRecentlyUsed
+        std::list<uint64_t>::iterator usePosition;
+        bool dirty;
+    } CachedChunk;
+
+    std::weak_ptr<VulkanResources> m_resources;
+    VkFormat m_colorFormat = VK_FORMAT_UNDEFINED;
+    VkSampler m_sampler = VK_NULL_HANDLE;
+    VkDescriptorSetLayout m_descriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE;
+    VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+    std::unique_ptr<Pipeline> m_pipeline;
+
+    uint32_t m_chunkSize = DEFAULT_CHUNK_SIZE;
+    uint32_t m_chunkPixels = 0;
+    uint32_t m_pixelsPerUnit = 0;
+    uint64_t m_frame = 0;
+
+    std::unordered_map<uint64_t, CachedChunk> m_chunks{};
+    // Keys of the resident chunks, least recently used first
+    std::list<uint64_t> m_leastRecentlyUsed{};
+    std::vector<const CachedChunk*> m_visibleChunks{};
+    std::vector<CachedChunk*> m_chunksToRender{};
+    ChunkCacheStatistics m_statistics{};
+
+    static uint64_t getKey(uint32_t chunkX, uint32_t chunkY)
+    {
+        return (static_cast<uint64_t>(chunkX) << 32) | chunkY;
+    }
+
+    void initializeSampler(VkDevice device, const VkAllocationCallbacks* allocator);
+    void initializeDescriptorSetLayout(VkDevice device, const VkAllocationCallbacks* allocator);
+    void initializeDescriptorPool(VkDevice device, const VkAllocationCallbacks* allocator, uint32_t framesInFlight);
+    void initializePipelineLayout(VkDevice device, const VkAllocationCallbacks* allocator);
+
+    CachedChunk* createChunk(VulkanResources& resources, uint32_t chunkX, uint32_t chunkY);
+    void markUsed(CachedChunk& chunk);
+    bool evictLeastRecentlyUsed(VkDeviceSize requiredBytes);
+    void destroyChunk(const CachedChunk& chunk);
+    void clear();
+
+    void renderChunks(
+        VkCommandBuffer commandBuffer,
+        const TilemapRenderer& tilemap,
+        VkDescriptorSet sceneDescriptorSet,
+        uint32_t indexCount);
+};
+
+#endif //CHUNKCACHE_H
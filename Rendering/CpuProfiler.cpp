@@ -0,0 +1,191 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include "CpuProfiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    typedef struct
+    {
+        const char* name;
+        uint64_t beginNanoseconds;
+        uint64_t endNanoseconds;
+    } ProfileEvent;
+
+    // The export reads slots the owning thread may be overwriting at the same time, so every field is atomic
+    typedef struct
+    {
+        std::atomic<const char*> name;
+        std::atomic<uint64_t> beginNanoseconds;
+        std::atomic<uint64_t> endNanoseconds;
+    } ProfileSlot;
+
+    typedef struct
+    {
+        uint32_t threadId;
+        std::atomic<const char*> name;
+        // Only the owning thread writes, published with release once the slot of the event is written
+        std::atomic<uint64_t> head;
+        std::unique_ptr<ProfileSlot[]> events;
+    } ThreadBuffer;
+
+    typedef struct
+    {
+        std::mutex mutex;
+        // Buffers outlive their threads, so scopes of threads that already finished are exported as well
+        std::vector<std::unique_ptr<ThreadBuffer>> threads;
+    } ThreadRegistry;
+
+    const auto EPOCH = std::chrono::steady_clock::now();
+    thread_local ThreadBuffer* t_threadBuffer = nullptr;
+
+    ThreadRegistry& getRegistry()
+    {
+        static ThreadRegistry registry{};
+        return registry;
+    }
+
+    ThreadBuffer& getThreadBuffer()
+    {
+        if (!t_threadBuffer)
+        {
+            ThreadRegistry& registry = getRegistry();
+            const std::lock_guard lock(registry.mutex);
+
+            auto buffer = std::make_unique<ThreadBuffer>();
+            buffer->threadId = static_cast<uint32_t>(registry.threads.size()) + 1;
+            buffer->events = std::make_unique<ProfileSlot[]>(CpuProfiler::EVENTS_PER_THREAD);
+
+            t_threadBuffer = buffer.get();
+            registry.threads.push_back(std::move(buffer));
+        }
+
+        return *t_threadBuffer;
+    }
+
+    void writeEscaped(std::ofstream& file, const char* text)
+    {
+        for (const char* c = text; *c != '\0'; c++)
+        {
+            if (*c == '"' || *c == '\\')
+            {
+                file << '\\';
+            }
+
+            file << *c;
+        }
+    }
+}
+
+uint64_t CpuProfiler::now()
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - EPOCH).count());
+}
+
+void CpuProfiler::record(const char* name, uint64_t beginNanoseconds, uint64_t endNanoseconds)
+{
+    ThreadBuffer& buffer = getThreadBuffer();
+    const uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    ProfileSlot& slot = buffer.events[head % EVENTS_PER_THREAD];
+
+    // An export that reads any of the new values also sees the head published before them, and drops the slot
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.beginNanoseconds.store(beginNanoseconds, std::memory_order_relaxed);
+    slot.endNanoseconds.store(endNanoseconds, std::memory_order_relaxed);
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void CpuProfiler::setThreadName(const char* name)
+{
+    getThreadBuffer().name.store(name, std::memory_order_relaxed);
+}
+
+void CpuProfiler::writeChromeTrace(const std::filesystem::path& filePath)
+{
+    std::ofstream file(filePath, std::ios::trunc);
+
+    if (!file)
+    {
+        throw std::runtime_error("failed to open " + filePath.string() + " for writing");
+    }
+
+    ThreadRegistry& registry = getRegistry();
+    const std::lock_guard lock(registry.mutex);
+
+    std::vector<ProfileEvent> events{};
+    events.reserve(EVENTS_PER_THREAD);
+    bool firstEntry = true;
+
+    file << "{\"traceEvents\":[";
+    file.setf(std::ios::fixed);
+    file.precision(3);
+
+    for (const auto& thread : registry.threads)
+    {
+        const char* threadName = thread->name.load(std::memory_order_relaxed);
+
+        if (threadName)
+        {
+            file << (firstEntry ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+                << thread->threadId << ",\"args\":{\"name\":\"";
+            writeEscaped(file, threadName);
+            file << "\"}}";
+            firstEntry = false;
+        }
+
+        const uint64_t head = thread->head.load(std::memory_order_acquire);
+        const uint64_t first = head > EVENTS_PER_THREAD ? head - EVENTS_PER_THREAD : 0;
+
+        events.clear();
+
+        // Only events up to the acquired head are complete
+        for (uint64_t i = first; i < head; i++)
+        {
+            const ProfileSlot& slot = thread->events[i % EVENTS_PER_THREAD];
+
+            events.push_back({
+                slot.name.load(std::memory_order_relaxed),
+                slot.beginNanoseconds.load(std::memory_order_relaxed),
+                slot.endNanoseconds.load(std::memory_order_relaxed)
+            });
+        }
+
+        // The thread keeps recording while this copies, events it may have overwritten since, including the one it
+        // may be writing right now, are dropped. The fence pairs with the one in record
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t headAfterCopy = thread->head.load(std::memory_order_relaxed);
+        const uint64_t firstValid = headAfterCopy + 1 > EVENTS_PER_THREAD ? headAfterCopy + 1 - EVENTS_PER_THREAD : 0;
+
+        for (uint64_t i = std::max(first, firstValid); i < head; i++)
+        {
+            const ProfileEvent& event = events[i - first];
+
+            file << (firstEntry ? "" : ",") << "\n{\"name\":\"";
+            writeEscaped(file, event.name);
+            file << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->threadId
+                << ",\"ts\":" << static_cast<double>(event.beginNanoseconds) / 1000.0
+                << ",\"dur\":" << static_cast<double>(event.endNanoseconds - event.beginNanoseconds) / 1000.0 << "}";
+            firstEntry = false;
+        }
+    }
+
+    file << "\n],\"displayTimeUnit\":\"ns\"}\n";
+
+    if (!file)
+    {
+        throw std::runtime_error("failed to write " + filePath.string());
+    }
+}
@@ -0,0 +1,80 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef CPUPROFILER_H
+#define CPUPROFILER_H
+
+#include <cstdint>
+#include <filesystem>
+
+// On in debug builds, release builds can turn it on by defining CPU_PROFILER_ENABLED=1
+#ifndef CPU_PROFILER_ENABLED
+#ifdef NDEBUG
+#define CPU_PROFILER_ENABLED 0
+#else
+#define CPU_PROFILER_ENABLED 1
+#endif
+#endif
+
+/**
+ * Records named CPU scopes with nanosecond timestamps into one ring buffer per thread. Writing a scope takes no lock,
+ * only the first scope of a thread registers its buffer. When a ring is full the oldest scopes are overwritten, so
+ * the export holds the last EVENTS_PER_THREAD scopes of every thread.
+ */
+class CpuProfiler
+{
+public:
+    static constexpr size_t EVENTS_PER_THREAD = 64 * 1024;
+
+    /**
+     * Nanoseconds since the profiler's epoch, monotonic across threads.
+     */
+    static uint64_t now();
+
+    /**
+     * name has to outlive the profiler, usually a string literal.
+     */
+    static void record(const char* name, uint64_t beginNanoseconds, uint64_t endNanoseconds);
+
+    /**
+     * Names the calling thread in exported traces. name has to outlive the profiler.
+     */
+    static void setThreadName(const char* name);
+
+    /**
+     * Writes the recorded scopes of all threads as Chrome trace event JSON, which chrome://tracing and the Perfetto UI
+     * open. Scopes overwritten by their thread while the trace is written are left out.
+     */
+    static void writeChromeTrace(const std::filesystem::path& filePath);
+};
+
+/**
+ * Records the time from its construction to its destruction as a scope of the calling thread.
+ */
+class CpuProfileScope
+{
+public:
+    explicit CpuProfileScope(const char* name) : m_name(name), m_begin(CpuProfiler::now()) {}
+    ~CpuProfileScope() { CpuProfiler::record(m_name, m_begin, CpuProfiler::now()); }
+
+    CpuProfileScope(const CpuProfileScope&) = delete;
+    CpuProfileScope& operator=(const CpuProfileScope&) = delete;
+
+private:
+    const char* m_name;
+    uint64_t m_begin;
+};
+
+#define CPU_PROFILE_CONCAT_INNER(a, b) a##b
+#define CPU_PROFILE_CONCAT(a, b) CPU_PROFILE_CONCAT_INNER(a, b)
+
+#if CPU_PROFILER_ENABLED
+#define PROFILE_SCOPE(name) const CpuProfileScope CPU_PROFILE_CONCAT(profileScope, __COUNTER__)(name)
+#define PROFILE_THREAD_NAME(name) CpuProfiler::setThreadName(name)
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_THREAD_NAME(name)
+#endif
+
+#endif //CPUPROFILER_H
@@ -0,0 +1,341 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include "CullingPass.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+#include "Shader.h"
+
+CullingPass::CullingPass(
+    const std::weak_ptr<VulkanResources>& resources,
+    const std::filesystem::path& shaderPath,
+    size_t frames)
+{
+    m_resources = resources;
+
+    const auto ptr = resources.lock();
+
+    if (!ptr)
+    {
+        return;
+    }
+
+    initializeDescriptorSetLayout(ptr->m_logicalDevice, ptr->m_allocator);
+    initializePipeline(ptr->m_logicalDevice, ptr->m_allocator, shaderPath);
+
+    std::vector<VkDescriptorSetLayout> layouts(frames, m_descriptorSetLayout);
+    m_descriptorSets.resize(frames);
+
+    VkDescriptorSetAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    allocInfo.descriptorPool = ptr->m_descriptorPool;
+    allocInfo.descriptorSetCount = static_cast<uint32_t>(frames);
+    allocInfo.pSetLayouts = layouts.data();
+
+    if (vkAllocateDescriptorSets(ptr->m_logicalDevice, &allocInfo, m_descriptorSets.data()) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to allocate culling descriptor sets!");
+    }
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        m_visibleIndexBuffers.emplace_back(
+            std::make_unique<GrowableBuffer>(
+                resources,
+                sizeof(uint32_t) * 1024,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+
+        m_drawCommandBuffers.emplace_back(
+            std::make_unique<GrowableBuffer>(
+                resources,
+                sizeof(VkDrawIndexedIndirectCommand) * 64,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+
+        m_groupBuffers.emplace_back(
+            std::make_unique<GrowableBuffer>(
+                resources,
+                sizeof(uint32_t) * 256,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+    }
+}
+
+CullingPass::~CullingPass()
+{
+    const auto ptr = m_resources.lock();
+
+    if (!ptr)
+    {
+        return;
+    }
+
+    m_visibleIndexBuffers.clear();
+    m_drawCommandBuffers.clear();
+    m_groupBuffers.clear();
+
+    for (const auto descriptorSet : m_descriptorSets)
+    {
+        ptr->m_deletionQueue->freeDescriptorSet(ptr->m_descriptorPool, descriptorSet);
+    }
+
+    ptr->m_deletionQueue->destroyPipeline(m_pipeline);
+
+    // Layouts only have to outlive the recording of command buffers that use them, not their execution
+    vkDestroyPipelineLayout(ptr->m_logicalDevice, m_pipelineLayout, ptr->m_allocator);
+    vkDestroyDescriptorSetLayout(ptr->m_logicalDevice, m_descriptorSetLayout, ptr->m_allocator);
+}
+
+void CullingPass::initializeDescriptorSetLayout(VkDevice device, const VkAllocationCallbacks* allocator)
+{
+    std::array<VkDescriptorSetLayoutBinding, 4> bindings{};
+
+    for (uint32_t i = 0; i < bindings.size(); i++)
+    {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo createInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    createInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    createInfo.pBindings = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(device, &createInfo, allocator, &m_descriptorSetLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create culling descriptor set layout");
+    }
+}
+
+void CullingPass::initializePipeline(
+    VkDevice device,
+    const VkAllocationCallbacks* allocator,
+    const std::filesystem::path& shaderPath)
+{
+    const auto resources = m_resources.lock();
+
+    // Sets 0 and 1 are the scene and object sets of the graphics pipelines, so they can be bound as they are
+    std::array layouts =
+    {
+        resources->m_descriptorSetLayout,
+        resources->m_descriptorSetLayoutObjectsBuffer,
+        m_descriptorSetLayout
+    };
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(CullParameters);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(layouts.size());
+    pipelineLayoutInfo.pSetLayouts = layouts.data();
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, allocator, &m_pipelineLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create culling pipeline layout");
+    }
+
+    const VkShaderModule shaderModule = Shader::loadModule(device, shaderPath);
+
+    VkComputePipelineCreateInfo pipelineInfo{ VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = shaderModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = m_pipelineLayout;
+
+    const VkResult result = vkCreateComputePipelines(
+        device,
+        resources->m_pipelineCache->getCache(),
+        1,
+        &pipelineInfo,
+        allocator,
+        &m_pipeline);
+
+    vkDestroyShaderModule(device, shaderModule, nullptr);
+
+    if (result != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create culling pipeline");
+    }
+}
+
+void CullingPass::record(
+    VkCommandBuffer commandBuffer,
+    size_t frameIndex,
+    VkDescriptorSet sceneDescriptorSet,
+    const VkDescriptorBufferInfo& candidates,
+    std::span<const CullBatch> batches,
+    uint32_t indexCount)
+{
+    const auto resources = m_resources.lock();
+
+    if (!resources || batches.empty())
+    {
+        return;
+    }
+
+    uint32_t groupCount = 0;
+
+    for (const auto& batch : batches)
+    {
+        groupCount += getGroupCount(batch);
+    }
+
+    m_visibleIndexBuffers[frameIndex]->reserve(commandBuffer, candidates.range);
+    m_drawCommandBuffers[frameIndex]->reserve(
+        commandBuffer,
+        sizeof(VkDrawIndexedIndirectCommand) * batches.size());
+
+    // Every value is written by the count pass before it is read, so the buffer is not cleared
+    m_groupBuffers[frameIndex]->reserve(commandBuffer, sizeof(uint32_t) * groupCount);
+
+    // Growing may have replaced any of the buffers, writing the set is cheaper than tracking that
+    writeDescriptors(resources->m_logicalDevice, frameIndex, candidates);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+
+    vkCmdBindDescriptorSets(
+        commandBuffer,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        m_pipelineLayout,
+        0,
+        1,
+        &sceneDescriptorSet,
+        0,
+        nullptr);
+
+    vkCmdBindDescriptorSets(
+        commandBuffer,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        m_pipelineLayout,
+        2,
+        1,
+        &m_descriptorSets[frameIndex],
+        0,
+        nullptr);
+
+    // The passes only depend on each other through the group buffer, the barriers between them replace any waiting
+    // of workgroups on other workgroups
+    recordPass(commandBuffer, batches, indexCount, PASS_COUNT);
+    recordComputeBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+    recordPass(commandBuffer, batches, indexCount, PASS_SCAN);
+    recordComputeBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+    recordPass(commandBuffer, batches, indexCount, PASS_COMPACT);
+    recordComputeBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+        VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT);
+}
+
+void CullingPass::recordPass(
+    VkCommandBuffer commandBuffer,
+    std::span<const CullBatch> batches,
+    uint32_t indexCount,
+    uint32_t pass) const
+{
+    uint32_t firstGroup = 0;
+
+    for (uint32_t i = 0; i < batches.size(); i++)
+    {
+        const auto& batch = batches[i];
+        const uint32_t batchGroups = getGroupCount(batch);
+
+        // The scan pass does not read objects, but the set stays bound from the count pass
+        if (pass != PASS_SCAN)
+        {
+            vkCmdBindDescriptorSets(
+                commandBuffer,
+                VK_PIPELINE_BIND_POINT_COMPUTE,
+                m_pipelineLayout,
+                1,
+                1,
+                &batch.objectDescriptorSet,
+                0,
+                nullptr);
+        }
+
+        const CullParameters parameters
+        {
+            batch.firstCandidate,
+            batch.candidateCount,
+            i,
+            indexCount,
+            batch.cull ? 1u : 0u,
+            firstGroup,
+            pass
+        };
+
+        vkCmdPushConstants(
+            commandBuffer,
+            m_pipelineLayout,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            0,
+            sizeof(CullParameters),
+            &parameters);
+
+        // One workgroup scans the group counts of the whole batch
+        vkCmdDispatch(commandBuffer, pass == PASS_SCAN ? 1 : batchGroups, 1, 1);
+        firstGroup += batchGroups;
+    }
+}
+
+void CullingPass::recordComputeBarrier(
+    VkCommandBuffer commandBuffer,
+    VkPipelineStageFlags dstStages,
+    VkAccessFlags dstAccess)
+{
+    VkMemoryBarrier barrier{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = dstAccess;
+
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        dstStages,
+        0,
+        1,
+        &barrier,
+        0,
+        nullptr,
+        0,
+        nullptr);
+}
+
+void CullingPass::writeDescriptors(VkDevice device, size_t frameIndex, const VkDescriptorBufferInfo& candidates) const
+{
+    std::array<VkDescriptorBufferInfo, 4> bufferInfos{};
+    bufferInfos[0] = candidates;
+    bufferInfos[1].buffer = m_visibleIndexBuffers[frameIndex]->getBuffer();
+    bufferInfos[1].offset = 0;
+    bufferInfos[1].range = VK_WHOLE_SIZE;
+    bufferInfos[2].buffer = m_drawCommandBuffers[frameIndex]->getBuffer();
+    bufferInfos[2].offset = 0;
+    bufferInfos[2].range = VK_WHOLE_SIZE;
+    bufferInfos[3].buffer = m_groupBuffers[frameIndex]->getBuffer();
+    bufferInfos[3].offset = 0;
+    bufferInfos[3].range = VK_WHOLE_SIZE;
+
+    std::array<VkWriteDescriptorSet, 4> writes{};
+
+    for (uint32_t i = 0; i < writes.size(); i++)
+    {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = m_descriptorSets[frameIndex];
+        writes[i].dstBinding = i;
+        writes[i].dstArrayElement = 0;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].descriptorCount = 1;
+        writes[i].pBufferInfo = &bufferInfos[i];
+    }
+
+    vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+}
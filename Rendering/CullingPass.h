@@ -0,0 +1,108 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef CULLINGPASS_H
+#define CULLINGPASS_H
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "GrowableBuffer.h"
+#include "UploadRing.h"
+#include "VulkanResources.h"
+
+typedef struct
+{
+    uint32_t firstCandidate;
+    uint32_t candidateCount;
+    VkDescriptorSet objectDescriptorSet;
+    bool cull;
+} CullBatch;
+
+/**
+ * Compute pass that frustum culls the instances of every draw batch against the camera and writes one
+ * VkDrawIndexedIndirectCommand per batch. Each batch dispatches one workgroup per 256 candidates in a count and a
+ * compact pass with a scan pass in between, so recording costs three dispatches per batch. The visible instance
+ * indices of a batch are compacted in order into the range of its candidates, so the indirect command of batch b uses
+ * the batch's first candidate as first instance.
+ * Batches whose objects are not sprites pass all candidates through.
+ */
+class CullingPass
+{
+public:
+    CullingPass(
+        const std::weak_ptr<VulkanResources>& resources,
+        const std::filesystem::path& shaderPath,
+        size_t frames);
+    ~CullingPass();
+
+    void record(
+        VkCommandBuffer commandBuffer,
+        size_t frameIndex,
+        VkDescriptorSet sceneDescriptorSet,
+        const VkDescriptorBufferInfo& candidates,
+        std::span<const CullBatch> batches,
+        uint32_t indexCount);
+
+    [[nodiscard]] VkBuffer getVisibleIndexBuffer(size_t frameIndex) const
+    {
+        return m_visibleIndexBuffers[frameIndex]->getBuffer();
+    }
+
+    [[nodiscard]] VkBuffer getDrawCommandBuffer(size_t frameIndex) const
+    {
+        return m_drawCommandBuffers[frameIndex]->getBuffer();
+    }
+
+private:
+    typedef struct
+    {
+        uint32_t firstCandidate;
+        uint32_t candidateCount;
+        uint32_t batchIndex;
+        uint32_t indexCount;
+        uint32_t cullEnabled;
+        uint32_t firstGroup;
+        uint32_t pass;
+    } CullParameters;
+
+    static constexpr uint32_t GROUP_SIZE = 256;
+    static constexpr uint32_t PASS_COUNT = 0;
+    static constexpr uint32_t PASS_SCAN = 1;
+    static constexpr uint32_t PASS_COMPACT = 2;
+
+    std::weak_ptr<VulkanResources> m_resources;
+    VkDescriptorSetLayout m_descriptorSetLayout = VK_NULL_HANDLE;
+    VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline m_pipeline = VK_NULL_HANDLE;
+
+    std::vector<VkDescriptorSet> m_descriptorSets{};
+    std::vector<std::unique_ptr<GrowableBuffer>> m_visibleIndexBuffers{};
+    std::vector<std::unique_ptr<GrowableBuffer>> m_drawCommandBuffers{};
+    std::vector<std::unique_ptr<GrowableBuffer>> m_groupBuffers{};
+
+    void initializeDescriptorSetLayout(VkDevice device, const VkAllocationCallbacks* allocator);
+    void initializePipeline(VkDevice device, const VkAllocationCallbacks* allocator, const std::filesystem::path& shaderPath);
+    void writeDescriptors(VkDevice device, size_t frameIndex, const VkDescriptorBufferInfo& candidates) const;
+    void recordPass(
+        VkCommandBuffer commandBuffer,
+        std::span<const CullBatch> batches,
+        uint32_t indexCount,
+        uint32_t pass) const;
+    static void recordComputeBarrier(
+        VkCommandBuffer commandBuffer,
+        VkPipelineStageFlags dstStages,
+        VkAccessFlags dstAccess);
+
+    [[nodiscard]] static uint32_t getGroupCount(const CullBatch& batch)
+    {
+        return std::max(1u, (batch.candidateCount + GROUP_SIZE - 1) / GROUP_SIZE);
+    }
+};
+
+#endif //CULLINGPASS_H
@@ -0,0 +1,155 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include "DeletionQueue.h"
+
+DeletionQueue::DeletionQueue(
+    VkDevice device,
+    const VkAllocationCallbacks* allocator,
+    MemoryAllocator& memoryAllocator)
+    : m_memoryAllocator(memoryAllocator)
+{
+    m_device = device;
+    m_allocator = allocator;
+}
+
+DeletionQueue::~DeletionQueue()
+{
+    flush();
+}
+
+void DeletionQueue::beginFrame()
+{
+    m_frameNumber++;
+
+    // Entries are enqueued with increasing safe frames, so the ready ones are always at the front
+    while (!m_pending.empty() && m_pending.front().safeFrame <= m_frameNumber)
+    {
+        destroy(m_pending.front());
+        m_pending.pop_front();
+    }
+}
+
+void DeletionQueue::flush()
+{
+    for (const auto& deletion : m_pending)
+    {
+        destroy(deletion);
+    }
+
+    m_pending.clear();
+}
+
+void DeletionQueue::destroyBuffer(VkBuffer buffer, const MemoryAllocation& allocation)
+{
+    PendingDeletion deletion{};
+    deletion.type = DeletionType::Buffer;
+    deletion.buffer = buffer;
+    deletion.allocation = allocation;
+    enqueue(deletion);
+}
+
+void DeletionQueue::destroyImage(VkImage image, const MemoryAllocation& allocation)
+{
+    PendingDeletion deletion{};
+    deletion.type = DeletionType::Image;
+    deletion.image = image;
+    deletion.allocation = allocation;
+    enqueue(deletion);
+}
+
+void DeletionQueue::destroyImageView(VkImageView imageView)
+{
+    PendingDeletion deletion{};
+    deletion.type = DeletionType::ImageView;
+    deletion.imageView = imageView;
+    enqueue(deletion);
+}
+
+void DeletionQueue::freeDescriptorSet(VkDescriptorPool descriptorPool, VkDescriptorSet descriptorSet)
+{
+    PendingDeletion deletion{};
+    deletion.type = DeletionType::DescriptorSet;
+    deletion.descriptorPool = descriptorPool;
+    deletion.descriptorSet = descriptorSet;
+    enqueue(deletion);
+}
+
+void DeletionQueue::destroyDescriptorPool(VkDescriptorPool descriptorPool)
+{
+    PendingDeletion deletion{};
+    deletion.type = DeletionType::DescriptorPool;
+    deletion.descriptorPool = descriptorPool;
+    enqueue(deletion);
+}
+
+void DeletionQueue::destroyPipeline(VkPipeline pipeline)
+{
+    PendingDeletion deletion{};
+    deletion.type = DeletionType::Pipeline;
+    deletion.pipeline = pipeline;
+    enqueue(deletion);
+}
+
+void DeletionQueue::destroySampler(VkSampler sampler)
+{
+    PendingDeletion deletion{};
+    deletion.type = DeletionType::Sampler;
+    deletion.sampler = sampler;
+    enqueue(deletion);
+}
+
+void DeletionQueue::destroyQueryPool(VkQueryPool queryPool)
+{
+    PendingDeletion deletion{};
+    deletion.type = DeletionType::QueryPool;
+    deletion.queryPool = queryPool;
+    enqueue(deletion);
+}
+
+void DeletionQueue::enqueue(PendingDeletion deletion)
+{
+    deletion.safeFrame = m_frameNumber + m_framesInFlight;
+    m_pending.push_back(deletion);
+}
+
+void DeletionQueue::destroy(const PendingDeletion& deletion) const
+{
+    switch (deletion.type)
+    {
+        case DeletionType::Buffer:
+            vkDestroyBuffer(m_device, deletion.buffer, m_allocator);
+            m_memoryAllocator.free(deletion.allocation);
+            break;
+
+        case DeletionType::Image:
+            vkDestroyImage(m_device, deletion.image, m_allocator);
+            m_memoryAllocator.free(deletion.allocation);
+            break;
+
+        case DeletionType::ImageView:
+            vkDestroyImageView(m_device, deletion.imageView, m_allocator);
+            break;
+
+        case DeletionType::DescriptorSet:
+            vkFreeDescriptorSets(m_device, deletion.descriptorPool, 1, &deletion.descriptorSet);
+            break;
+
+        case DeletionType::DescriptorPool:
+            vkDestroyDescriptorPool(m_device, deletion.descriptorPool, m_allocator);
+            break;
+
+        case DeletionType::Pipeline:
+            vkDestroyPipeline(m_device, deletion.pipeline, m_allocator);
+            break;
+
+        case DeletionType::Sampler:
+            vkDestroySampler(m_device, deletion.sampler, m_allocator);
+            break;
+
+        case DeletionType::QueryPool:
+            vkDestroyQueryPool(m_device, deletion.queryPool, m_allocator);
+            break;
+    }
+}
@@ -0,0 +1,93 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef DELETIONQUEUE_H
+#define DELETIONQUEUE_H
+
+#include <deque>
+#include <vulkan/vulkan.h>
+
+#include "MemoryAllocator.h"
+
+enum class DeletionType
+{
+    Buffer,
+    Image,
+    ImageView,
+    DescriptorSet,
+    DescriptorPool,
+    Pipeline,
+    Sampler,
+    QueryPool
+};
+
+typedef struct
+{
+    uint64_t safeFrame;
+    DeletionType type;
+
+    VkBuffer buffer;
+    VkImage image;
+    VkImageView imageView;
+    VkDescriptorPool descriptorPool;
+    VkDescriptorSet descriptorSet;
+    VkPipeline pipeline;
+    VkSampler sampler;
+    VkQueryPool queryPool;
+    MemoryAllocation allocation;
+} PendingDeletion;
+
+/**
+ * Defers the destruction of Vulkan objects until every frame that may still use them has finished on the GPU.
+ * Objects enqueued during frame N are destroyed at the beginning of frame N + framesInFlight, after the renderer
+ * waited for the frame ring slot of that frame, which frame N used last.
+ */
+class DeletionQueue
+{
+public:
+    DeletionQueue(
+        VkDevice device,
+        const VkAllocationCallbacks* allocator,
+        MemoryAllocator& memoryAllocator);
+    ~DeletionQueue();
+
+    void setFramesInFlight(uint32_t framesInFlight) { m_framesInFlight = framesInFlight; }
+    [[nodiscard]] uint32_t getFramesInFlight() const { return m_framesInFlight; }
+
+    /**
+     * Advances to the next frame and destroys everything that became safe. Must be called once per frame, after
+     * the frame ring waited for the slot about to be reused.
+     */
+    void beginFrame();
+
+    /**
+     * Destroys everything right away. Only valid while the device is idle.
+     */
+    void flush();
+
+    void destroyBuffer(VkBuffer buffer, const MemoryAllocation& allocation);
+    void destroyImage(VkImage image, const MemoryAllocation& allocation);
+    void destroyImageView(VkImageView imageView);
+    void freeDescriptorSet(VkDescriptorPool descriptorPool, VkDescriptorSet descriptorSet);
+    void destroyDescriptorPool(VkDescriptorPool descriptorPool);
+    void destroyPipeline(VkPipeline pipeline);
+    void destroySampler(VkSampler sampler);
+    void destroyQueryPool(VkQueryPool queryPool);
+
+    [[nodiscard]] uint64_t getFrameNumber() const { return m_frameNumber; }
+    [[nodiscard]] size_t getPendingCount() const { return m_pending.size(); }
+
+private:
+    VkDevice m_device = VK_NULL_HANDLE;
+    const VkAllocationCallbacks* m_allocator = nullptr;
+    MemoryAllocator& m_memoryAllocator;
+    uint32_t m_framesInFlight = 1;
+    uint64_t m_frameNumber = 0;
+    std::deque<PendingDeletion> m_pending{};
+
+    void enqueue(PendingDeletion deletion);
+    void destroy(const PendingDeletion& deletion) const;
+};
+
+#endif //DELETIONQUEUE_H
@@ -0,0 +1,114 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include "DrawKey.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+uint64_t DrawKey::pack(const DrawRequest& request)
+{
+    if (request.layer >= (1u << LAYER_BITS) ||
+        request.pipelineIndex >= (size_t{1} << PIPELINE_BITS) ||
+        request.instanceIndex >= (size_t{1} << INSTANCE_BITS))
+    {
+        throw std::runtime_error("Draw request exceeds the draw key range");
+    }
+
+    const uint64_t order = std::min<uint32_t>(request.orderInLayer, (1u << ORDER_BITS) - 1);
+
+    return (static_cast<uint64_t>(request.layer) << (ORDER_BITS + PIPELINE_BITS + INSTANCE_BITS)) |
+        (order << (PIPELINE_BITS + INSTANCE_BITS)) |
+        (static_cast<uint64_t>(request.pipelineIndex) << INSTANCE_BITS) |
+        static_cast<uint64_t>(request.instanceIndex);
+}
+
+void DrawKey::sort(std::vector<uint64_t>& keys, std::vector<uint64_t>& scratch)
+{
+    constexpr size_t PASSES = sizeof(uint64_t);
+    constexpr size_t BUCKETS = 256;
+
+    if (keys.size() < 2)
+    {
+        return;
+    }
+
+    // Histograms of all passes in one read over the keys
+    std::array<std::array<size_t, BUCKETS>, PASSES> counts{};
+
+    for (const uint64_t key : keys)
+    {
+        for (size_t pass = 0; pass < PASSES; pass++)
+        {
+            counts[pass][(key >> (pass * 8)) & 0xFF]++;
+        }
+    }
+
+    scratch.resize(keys.size());
+
+    uint64_t* source = keys.data();
+    uint64_t* destination = scratch.data();
+
+    for (size_t pass = 0; pass < PASSES; pass++)
+    {
+        auto& passCounts = counts[pass];
+        const uint32_t shift = static_cast<uint32_t>(pass * 8);
+
+        // All keys share this byte, the pass would not change the order
+        if (passCounts[(source[0] >> shift) & 0xFF] == keys.size())
+        {
+            continue;
+        }
+
+        size_t offset = 0;
+
+        for (auto& count : passCounts)
+        {
+            const size_t bucketSize = count;
+            count = offset;
+            offset += bucketSize;
+        }
+
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            const uint64_t key = source[i];
+            destination[passCounts[(key >> shift) & 0xFF]++] = key;
+        }
+
+        std::swap(source, destination);
+    }
+
+    if (source != keys.data())
+    {
+        std::copy_n(source, keys.size(), keys.data());
+    }
+}
+
+void DrawKey::buildBatches(const std::vector<uint64_t>& keys, std::vector<DrawBatch>& batches)
+{
+    batches.clear();
+
+    size_t batchStartIndex = 0;
+
+    while (batchStartIndex < keys.size())
+    {
+        const uint64_t currentBatchStartKey = keys[batchStartIndex];
+        const uint32_t batchLayer = getLayer(currentBatchStartKey);
+        const size_t batchPipelineIndex = getPipelineIndex(currentBatchStartKey);
+        size_t batchEndIndex = batchStartIndex;
+
+        // Consecutive keys of the same layer and pipeline become one draw
+        while (
+            batchEndIndex < keys.size() - 1 &&
+            getLayer(keys[batchEndIndex + 1]) == batchLayer &&
+            getPipelineIndex(keys[batchEndIndex + 1]) == batchPipelineIndex)
+        {
+            batchEndIndex += 1;
+        }
+
+        batches.push_back({ batchStartIndex, batchEndIndex, batchPipelineIndex });
+        batchStartIndex = batchEndIndex + 1;
+    }
+}
@@ -0,0 +1,68 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef DRAWKEY_H
+#define DRAWKEY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "DrawRequest.h"
+
+typedef struct
+{
+    size_t firstKey;
+    size_t lastKey;
+    size_t pipelineIndex;
+} DrawBatch;
+
+/**
+ * Packs a DrawRequest into one 64 bit integer whose numeric order is the draw order:
+ *
+ *   63         50 49             34 33        28 27            0
+ *   |   layer    | order in layer  |  pipeline  |   instance    |
+ *
+ * Order in layer is clamped to 16 bits. The pipeline only breaks ties within the same order, so objects of different
+ * pipelines in one layer keep their painter's order. The instance index makes the order deterministic like the
+ * stable sort it replaces, for callers that submit instances in ascending order.
+ */
+class DrawKey
+{
+public:
+    static constexpr uint32_t LAYER_BITS = 14;
+    static constexpr uint32_t ORDER_BITS = 16;
+    static constexpr uint32_t PIPELINE_BITS = 6;
+    static constexpr uint32_t INSTANCE_BITS = 28;
+
+    static uint64_t pack(const DrawRequest& request);
+
+    [[nodiscard]] static uint32_t getLayer(uint64_t key)
+    {
+        return static_cast<uint32_t>(key >> (ORDER_BITS + PIPELINE_BITS + INSTANCE_BITS));
+    }
+
+    [[nodiscard]] static size_t getPipelineIndex(uint64_t key)
+    {
+        return (key >> INSTANCE_BITS) & ((uint64_t{1} << PIPELINE_BITS) - 1);
+    }
+
+    [[nodiscard]] static size_t getInstanceIndex(uint64_t key)
+    {
+        return key & ((uint64_t{1} << INSTANCE_BITS) - 1);
+    }
+
+    /**
+     * LSD radix sort over bytes. scratch is resized as needed and meant to be reused between calls, passes over bytes
+     * that are the same in every key are skipped.
+     */
+    static void sort(std::vector<uint64_t>& keys, std::vector<uint64_t>& scratch);
+
+    /**
+     * Turns runs of sorted keys with the same layer and pipeline into one batch each, batches is cleared first.
+     */
+    static void buildBatches(const std::vector<uint64_t>& keys, std::vector<DrawBatch>& batches);
+};
+
+#endif //DRAWKEY_H
@@ -4,6 +4,7 @@
 
 #ifndef DRAWREQUEST_H
 #define DRAWREQUEST_H
+#include <cstddef>
 #include <cstdint>
 
 typedef struct
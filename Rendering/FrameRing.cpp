@@ -0,0 +1,164 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include "FrameRing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+#include "CpuProfiler.h"
+
+FrameRing::FrameRing(
+    VkDevice device,
+    uint32_t queueFamilyIndex,
+    const VkAllocationCallbacks* allocator,
+    uint32_t framesInFlight)
+{
+    m_device = device;
+    m_allocator = allocator;
+
+    VkSemaphoreTypeCreateInfo timelineInfo{ VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO };
+    timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    timelineInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo timelineCreateInfo{ VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+    timelineCreateInfo.pNext = &timelineInfo;
+
+    if (vkCreateSemaphore(m_device, &timelineCreateInfo, m_allocator, &m_timeline) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create frame timeline semaphore!");
+    }
+
+    m_frames.resize(std::max(framesInFlight, 1u));
+
+    for (auto& frame : m_frames)
+    {
+        // Resetting the whole pool of a slot is cheaper than resetting its command buffer
+        VkCommandPoolCreateInfo commandPoolCreateInfo{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+        commandPoolCreateInfo.queueFamilyIndex = queueFamilyIndex;
+        commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+        if (vkCreateCommandPool(m_device, &commandPoolCreateInfo, m_allocator, &frame.commandPool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create frame command pool!");
+        }
+
+        VkCommandBufferAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+        allocInfo.commandPool = frame.commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+
+        if (vkAllocateCommandBuffers(m_device, &allocInfo, &frame.commandBuffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to allocate frame command buffer!");
+        }
+
+        VkSemaphoreCreateInfo semaphoreCreateInfo{ VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+
+        if (vkCreateSemaphore(m_device, &semaphoreCreateInfo, m_allocator, &frame.acquireSemaphore) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create acquire semaphore!");
+        }
+
+        frame.submittedValue = 0;
+    }
+
+    // The first beginFrame moves to slot 0
+    m_frameIndex = m_frames.size() - 1;
+}
+
+FrameRing::~FrameRing()
+{
+    for (const auto& frame : m_frames)
+    {
+        vkDestroySemaphore(m_device, frame.acquireSemaphore, m_allocator);
+        vkDestroyCommandPool(m_device, frame.commandPool, m_allocator);
+    }
+
+    vkDestroySemaphore(m_device, m_timeline, m_allocator);
+}
+
+FrameContext& FrameRing::beginFrame()
+{
+    m_frameIndex = (m_frameIndex + 1) % m_frames.size();
+    FrameContext& frame = m_frames[m_frameIndex];
+
+    // Frames that never submitted leave their slot's value behind, the second bound keeps the number of pending
+    // submissions below the ring size anyway
+    const uint64_t pendingLimit = m_frames.size() - 1;
+    const uint64_t ringValue = m_submittedValue > pendingLimit ? m_submittedValue - pendingLimit : 0;
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    wait(std::max(frame.submittedValue, ringValue));
+    m_lastWaitMilliseconds = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+
+    if (vkResetCommandPool(m_device, frame.commandPool, 0) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to reset frame command pool!");
+    }
+
+    return frame;
+}
+
+void FrameRing::submit(VkQueue queue, VkSemaphore acquireSemaphore, VkSemaphore renderFinishedSemaphore)
+{
+    FrameContext& frame = m_frames[m_frameIndex];
+    const uint64_t signalValue = m_submittedValue + 1;
+
+    // Binary semaphores ignore their entry in the value arrays
+    const VkSemaphore signalSemaphores[] = { m_timeline, renderFinishedSemaphore };
+    const uint64_t signalValues[] = { signalValue, 0 };
+    const uint32_t signalCount = renderFinishedSemaphore != VK_NULL_HANDLE ? 2 : 1;
+
+    const uint64_t waitValue = 0;
+    const uint32_t waitCount = acquireSemaphore != VK_NULL_HANDLE ? 1 : 0;
+
+    VkTimelineSemaphoreSubmitInfo timelineSubmitInfo{ VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO };
+    timelineSubmitInfo.waitSemaphoreValueCount = waitCount;
+    timelineSubmitInfo.pWaitSemaphoreValues = &waitValue;
+    timelineSubmitInfo.signalSemaphoreValueCount = signalCount;
+    timelineSubmitInfo.pSignalSemaphoreValues = signalValues;
+
+    const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+
+    VkSubmitInfo submitInfo{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
+    submitInfo.pNext = &timelineSubmitInfo;
+    submitInfo.waitSemaphoreCount = waitCount;
+    submitInfo.pWaitSemaphores = &acquireSemaphore;
+    submitInfo.pWaitDstStageMask = &waitStage;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &frame.commandBuffer;
+    submitInfo.signalSemaphoreCount = signalCount;
+    submitInfo.pSignalSemaphores = signalSemaphores;
+
+    if (vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to submit frame command buffer!");
+    }
+
+    m_submittedValue = signalValue;
+    frame.submittedValue = signalValue;
+}
+
+void FrameRing::wait(uint64_t value) const
+{
+    if (value == 0)
+    {
+        return;
+    }
+
+    PROFILE_SCOPE("Wait for frame");
+
+    VkSemaphoreWaitInfo waitInfo{ VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO };
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &m_timeline;
+    waitInfo.pValues = &value;
+
+    if (vkWaitSemaphores(m_device, &waitInfo, UINT64_MAX) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to wait for frame timeline semaphore!");
+    }
+}
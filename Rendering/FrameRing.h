@@ -0,0 +1,75 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef FRAMERING_H
+#define FRAMERING_H
+
+#include <vector>
+#include <vulkan/vulkan.h>
+
+typedef struct
+{
+    VkCommandPool commandPool;
+    VkCommandBuffer commandBuffer;
+    VkSemaphore acquireSemaphore;
+    // Value the timeline semaphore reaches once the last submission of this frame slot finished
+    uint64_t submittedValue;
+} FrameContext;
+
+/**
+ * Ring of the resources a frame records into, with a fixed number of frames in flight that does not depend on the
+ * swapchain image count. While the GPU executes frame N the CPU records frame N + 1 into the next slot.
+ * One timeline semaphore tracks every submission: the n-th submission signals n, so reusing a slot waits for the
+ * value of its previous submission instead of a fence per slot or per swapchain image.
+ */
+class FrameRing
+{
+public:
+    static constexpr uint32_t DEFAULT_FRAMES_IN_FLIGHT = 2;
+
+    FrameRing(
+        VkDevice device,
+        uint32_t queueFamilyIndex,
+        const VkAllocationCallbacks* allocator,
+        uint32_t framesInFlight = DEFAULT_FRAMES_IN_FLIGHT);
+
+    /**
+     * Expects the device to be idle.
+     */
+    ~FrameRing();
+
+    /**
+     * Moves to the next slot, waits until the GPU finished its previous submission and resets its command pool.
+     */
+    FrameContext& beginFrame();
+
+    /**
+     * Submits the command buffer of the current slot. It waits for acquireSemaphore before writing color attachments
+     * and signals renderFinishedSemaphore for the present along with the next timeline value. Both can be
+     * VK_NULL_HANDLE when nothing is presented.
+     */
+    void submit(VkQueue queue, VkSemaphore acquireSemaphore, VkSemaphore renderFinishedSemaphore);
+
+    [[nodiscard]] FrameContext& getCurrentFrame() { return m_frames[m_frameIndex]; }
+    [[nodiscard]] size_t getFrameIndex() const { return m_frameIndex; }
+    [[nodiscard]] uint32_t getFramesInFlight() const { return static_cast<uint32_t>(m_frames.size()); }
+
+    /**
+     * Time the last beginFrame blocked on the GPU. Near zero while the CPU is the bottleneck.
+     */
+    [[nodiscard]] double getLastWaitMilliseconds() const { return m_lastWaitMilliseconds; }
+
+private:
+    VkDevice m_device = VK_NULL_HANDLE;
+    const VkAllocationCallbacks* m_allocator = nullptr;
+    VkSemaphore m_timeline = VK_NULL_HANDLE;
+    std::vector<FrameContext> m_frames{};
+    size_t m_frameIndex = 0;
+    uint64_t m_submittedValue = 0;
+    double m_lastWaitMilliseconds = 0.0;
+
+    void wait(uint64_t value) const;
+};
+
+#endif //FRAMERING_H
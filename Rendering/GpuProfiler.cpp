@@ -0,0 +1,254 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include "GpuProfiler.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    constexpr VkQueryPipelineStatisticFlags STATISTIC_FLAGS =
+        VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+    // Results are written in the order of the flag bits
+    constexpr uint32_t STATISTIC_COUNT = 2;
+
+    VkQueryPool createQueryPool(
+        VkDevice device,
+        const VkAllocationCallbacks* allocator,
+        VkQueryType type,
+        uint32_t count,
+        VkQueryPipelineStatisticFlags statistics)
+    {
+        VkQueryPoolCreateInfo createInfo{ VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+        createInfo.queryType = type;
+        createInfo.queryCount = count;
+        createInfo.pipelineStatistics = statistics;
+
+        VkQueryPool queryPool = VK_NULL_HANDLE;
+
+        if (vkCreateQueryPool(device, &createInfo, allocator, &queryPool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create query pool!");
+        }
+
+        return queryPool;
+    }
+}
+
+GpuProfiler::GpuProfiler(const std::weak_ptr<VulkanResources>& resources, size_t frames)
+{
+    m_resources = resources;
+
+    const auto ptr = resources.lock();
+
+    if (!ptr)
+    {
+        return;
+    }
+
+    m_device = ptr->m_logicalDevice;
+
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(ptr->m_physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(ptr->m_physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    const uint32_t validBits = queueFamilies[ptr->m_graphicsQueueFamilyIndex].timestampValidBits;
+
+    if (validBits == 0)
+    {
+        return;
+    }
+
+    m_timestampMask = validBits >= 64 ? UINT64_MAX : (uint64_t{1} << validBits) - 1;
+    m_millisecondsPerTick = static_cast<double>(ptr->m_physicalDeviceProperties.limits.timestampPeriod) / 1000000.0;
+    m_scopes.resize(frames);
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        m_timestampPools.push_back(
+            createQueryPool(m_device, ptr->m_allocator, VK_QUERY_TYPE_TIMESTAMP, MAX_SCOPES * 2, 0));
+
+        if (ptr->m_enabledFeatures.pipelineStatisticsQuery)
+        {
+            m_statisticsPools.push_back(
+                createQueryPool(
+                    m_device,
+                    ptr->m_allocator,
+                    VK_QUERY_TYPE_PIPELINE_STATISTICS,
+                    MAX_SCOPES,
+                    STATISTIC_FLAGS));
+        }
+    }
+
+    m_timestamps.resize(MAX_SCOPES * 2);
+    m_statistics.resize(MAX_SCOPES * STATISTIC_COUNT);
+    m_results.reserve(MAX_SCOPES);
+}
+
+GpuProfiler::~GpuProfiler()
+{
+    const auto ptr = m_resources.lock();
+
+    if (!ptr)
+    {
+        return;
+    }
+
+    // Frames in flight may still write their queries
+    for (const auto queryPool : m_timestampPools)
+    {
+        ptr->m_deletionQueue->destroyQueryPool(queryPool);
+    }
+
+    for (const auto queryPool : m_statisticsPools)
+    {
+        ptr->m_deletionQueue->destroyQueryPool(queryPool);
+    }
+}
+
+void GpuProfiler::beginFrame(VkCommandBuffer commandBuffer, size_t frameIndex)
+{
+    m_frameIndex = frameIndex;
+    m_frameActive = false;
+
+    if (!isAvailable())
+    {
+        return;
+    }
+
+    if (!m_scopes[frameIndex].empty())
+    {
+        readResults(frameIndex);
+        m_scopes[frameIndex].clear();
+    }
+
+    if (!m_enabled)
+    {
+        return;
+    }
+
+    vkCmdResetQueryPool(commandBuffer, m_timestampPools[frameIndex], 0, MAX_SCOPES * 2);
+
+    if (hasPipelineStatistics())
+    {
+        vkCmdResetQueryPool(commandBuffer, m_statisticsPools[frameIndex], 0, MAX_SCOPES);
+    }
+
+    m_frameActive = true;
+}
+
+uint32_t GpuProfiler::beginScope(VkCommandBuffer commandBuffer, const char* name, uint32_t id)
+{
+    auto& scopes = m_scopes[m_frameIndex];
+
+    if (!m_frameActive || scopes.size() == MAX_SCOPES)
+    {
+        return NO_SCOPE;
+    }
+
+    const auto scope = static_cast<uint32_t>(scopes.size());
+    scopes.push_back({ name, id });
+
+    vkCmdWriteTimestamp(
+        commandBuffer,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        m_timestampPools[m_frameIndex],
+        scope * 2);
+
+    if (hasPipelineStatistics())
+    {
+        vkCmdBeginQuery(commandBuffer, m_statisticsPools[m_frameIndex], scope, 0);
+    }
+
+    return scope;
+}
+
+void GpuProfiler::endScope(VkCommandBuffer commandBuffer, uint32_t scope)
+{
+    if (scope == NO_SCOPE)
+    {
+        return;
+    }
+
+    if (hasPipelineStatistics())
+    {
+        vkCmdEndQuery(commandBuffer, m_statisticsPools[m_frameIndex], scope);
+    }
+
+    vkCmdWriteTimestamp(
+        commandBuffer,
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        m_timestampPools[m_frameIndex],
+        scope * 2 + 1);
+}
+
+void GpuProfiler::readResults(size_t frameIndex)
+{
+    const auto& scopes = m_scopes[frameIndex];
+    const auto scopeCount = static_cast<uint32_t>(scopes.size());
+
+    // No wait flag, a slot whose frame is not done yet keeps the previous results instead of stalling
+    VkResult result = vkGetQueryPoolResults(
+        m_device,
+        m_timestampPools[frameIndex],
+        0,
+        scopeCount * 2,
+        sizeof(uint64_t) * scopeCount * 2,
+        m_timestamps.data(),
+        sizeof(uint64_t),
+        VK_QUERY_RESULT_64_BIT);
+
+    if (result != VK_SUCCESS)
+    {
+        return;
+    }
+
+    if (hasPipelineStatistics())
+    {
+        result = vkGetQueryPoolResults(
+            m_device,
+            m_statisticsPools[frameIndex],
+            0,
+            scopeCount,
+            sizeof(uint64_t) * scopeCount * STATISTIC_COUNT,
+            m_statistics.data(),
+            sizeof(uint64_t) * STATISTIC_COUNT,
+            VK_QUERY_RESULT_64_BIT);
+
+        if (result != VK_SUCCESS)
+        {
+            return;
+        }
+    }
+
+    m_results.clear();
+    uint64_t frameBegin = UINT64_MAX;
+    uint64_t frameEnd = 0;
+
+    for (uint32_t i = 0; i < scopeCount; i++)
+    {
+        const uint64_t begin = m_timestamps[i * 2] & m_timestampMask;
+        const uint64_t end = m_timestamps[i * 2 + 1] & m_timestampMask;
+        const uint64_t ticks = (end - begin) & m_timestampMask;
+
+        frameBegin = std::min(frameBegin, begin);
+        frameEnd = std::max(frameEnd, end);
+
+        m_results.push_back({
+            scopes[i].name,
+            scopes[i].id,
+            static_cast<double>(ticks) * m_millisecondsPerTick,
+            hasPipelineStatistics() ? m_statistics[i * STATISTIC_COUNT] : 0,
+            hasPipelineStatistics() ? m_statistics[i * STATISTIC_COUNT + 1] : 0
+        });
+    }
+
+    m_frameMilliseconds = frameEnd > frameBegin
+        ? static_cast<double>(frameEnd - frameBegin) * m_millisecondsPerTick
+        : 0.0;
+}
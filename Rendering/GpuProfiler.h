@@ -0,0 +1,106 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef GPUPROFILER_H
+#define GPUPROFILER_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "VulkanResources.h"
+
+typedef struct
+{
+    const char* name;
+    uint32_t id;
+    double milliseconds;
+    // Zero without pipeline statistics queries
+    uint64_t vertexInvocations;
+    uint64_t fragmentInvocations;
+} GpuScopeTiming;
+
+/**
+ * Measures scopes of a frame on the GPU with a timestamp before and after each scope and, when the device supports
+ * it, a pipeline statistics query around it. Every frame slot has its own query pools, whose results are read when
+ * the slot is used again. The frame ring waited for that slot's last submission by then, so reading never stalls and
+ * the results are framesInFlight frames old.
+ * Scopes must not nest, only one pipeline statistics query can be active at a time.
+ */
+class GpuProfiler
+{
+public:
+    static constexpr uint32_t MAX_SCOPES = 256;
+    static constexpr uint32_t NO_SCOPE = UINT32_MAX;
+    static constexpr uint32_t NO_ID = UINT32_MAX;
+
+    GpuProfiler(const std::weak_ptr<VulkanResources>& resources, size_t frames);
+    ~GpuProfiler();
+
+    /**
+     * Reads the results of the last frame that used frameIndex and resets its queries. Has to be recorded at the
+     * beginning of the command buffer, outside of rendering.
+     */
+    void beginFrame(VkCommandBuffer commandBuffer, size_t frameIndex);
+
+    /**
+     * name has to outlive the results, usually a string literal. id tells scopes with the same name apart.
+     * Returns NO_SCOPE while disabled or once all scopes of the frame are used, endScope ignores it.
+     */
+    uint32_t beginScope(VkCommandBuffer commandBuffer, const char* name, uint32_t id = NO_ID);
+    void endScope(VkCommandBuffer commandBuffer, uint32_t scope);
+
+    /**
+     * Takes effect with the next beginFrame. Disabled profilers record no commands.
+     */
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+    [[nodiscard]] bool isEnabled() const { return m_enabled; }
+
+    /**
+     * False when the graphics queue has no timestamp support, the profiler stays disabled then.
+     */
+    [[nodiscard]] bool isAvailable() const { return m_timestampMask != 0; }
+    [[nodiscard]] bool hasPipelineStatistics() const { return !m_statisticsPools.empty(); }
+
+    /**
+     * Scopes of the newest frame with complete results, in recording order.
+     */
+    [[nodiscard]] const std::vector<GpuScopeTiming>& getResults() const { return m_results; }
+
+    /**
+     * From the beginning of the first to the end of the last scope of that frame.
+     */
+    [[nodiscard]] double getFrameMilliseconds() const { return m_frameMilliseconds; }
+
+private:
+    typedef struct
+    {
+        const char* name;
+        uint32_t id;
+    } ScopeInfo;
+
+    std::weak_ptr<VulkanResources> m_resources;
+    VkDevice m_device = VK_NULL_HANDLE;
+    double m_millisecondsPerTick = 0.0;
+    uint64_t m_timestampMask = 0;
+    bool m_enabled = false;
+
+    // Indexed by frame slot
+    std::vector<VkQueryPool> m_timestampPools{};
+    std::vector<VkQueryPool> m_statisticsPools{};
+    std::vector<std::vector<ScopeInfo>> m_scopes{};
+
+    size_t m_frameIndex = 0;
+    bool m_frameActive = false;
+
+    std::vector<uint64_t> m_timestamps{};
+    std::vector<uint64_t> m_statistics{};
+    std::vector<GpuScopeTiming> m_results{};
+    double m_frameMilliseconds = 0.0;
+
+    void readResults(size_t frameIndex);
+};
+
+#endif //GPUPROFILER_H
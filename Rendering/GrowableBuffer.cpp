@@ -0,0 +1,71 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include "GrowableBuffer.h"
+
+#include <algorithm>
+
+GrowableBuffer::GrowableBuffer(
+    const std::weak_ptr<VulkanResources>& resources,
+    VkDeviceSize initialSize,
+    VkBufferUsageFlags usage,
+    VkMemoryPropertyFlags properties)
+{
+    m_resources = resources;
+    m_usage = usage | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    m_properties = properties;
+    m_buffer = std::make_unique<Buffer>(resources, std::max<VkDeviceSize>(initialSize, 1), m_usage, properties);
+}
+
+bool GrowableBuffer::reserve(VkCommandBuffer commandBuffer, VkDeviceSize size)
+{
+    const VkDeviceSize currentSize = m_buffer->getSize();
+
+    if (size <= currentSize)
+    {
+        return false;
+    }
+
+    VkDeviceSize newSize = currentSize;
+
+    while (newSize < size)
+    {
+        newSize *= 2;
+    }
+
+    auto newBuffer = std::make_unique<Buffer>(m_resources, newSize, m_usage, m_properties);
+
+    VkBufferCopy copyRegion{};
+    copyRegion.srcOffset = 0;
+    copyRegion.dstOffset = 0;
+    copyRegion.size = currentSize;
+
+    vkCmdCopyBuffer(commandBuffer, m_buffer->getBuffer(), newBuffer->getBuffer(), 1, &copyRegion);
+
+    // Later uploads in the same command buffer may overwrite parts of the copied range
+    VkBufferMemoryBarrier barrier{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = newBuffer->getBuffer();
+    barrier.offset = 0;
+    barrier.size = currentSize;
+
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0,
+        0,
+        nullptr,
+        1,
+        &barrier,
+        0,
+        nullptr);
+
+    m_buffer = std::move(newBuffer);
+
+    return true;
+}
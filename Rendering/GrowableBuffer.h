@@ -0,0 +1,44 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef GROWABLEBUFFER_H
+#define GROWABLEBUFFER_H
+
+#include <memory>
+#include <vulkan/vulkan.h>
+
+#include "Buffer.h"
+#include "VulkanResources.h"
+
+/**
+ * Device buffer that grows geometrically while keeping its contents. Growing records a GPU copy from the old buffer
+ * into the new one. The old buffer goes through the deletion queue, so it stays alive until that copy and every
+ * frame that used it have finished.
+ */
+class GrowableBuffer
+{
+public:
+    GrowableBuffer(
+        const std::weak_ptr<VulkanResources>& resources,
+        VkDeviceSize initialSize,
+        VkBufferUsageFlags usage,
+        VkMemoryPropertyFlags properties);
+
+    /**
+     * Makes sure the buffer holds at least size bytes. Returns true if the VkBuffer was replaced,
+     * in which case descriptors referencing it have to be rewritten.
+     */
+    bool reserve(VkCommandBuffer commandBuffer, VkDeviceSize size);
+
+    [[nodiscard]] VkBuffer getBuffer() const { return m_buffer->getBuffer(); }
+    [[nodiscard]] VkDeviceSize getSize() const { return m_buffer->getSize(); }
+
+private:
+    std::weak_ptr<VulkanResources> m_resources;
+    VkBufferUsageFlags m_usage;
+    VkMemoryPropertyFlags m_properties;
+    std::unique_ptr<Buffer> m_buffer;
+};
+
+#endif //GROWABLEBUFFER_H
@@ -5,6 +5,11 @@
 #ifndef IGENERICBUFFERINTERFACE_H
 #define IGENERICBUFFERINTERFACE_H
 
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "UploadRing.h"
+
 class IGenericBuffer
 {
 public:
@@ -12,13 +17,19 @@ public:
     [[nodiscard]] virtual void* getData() =  0;
     [[nodiscard]] virtual size_t getStride() const = 0;
     [[nodiscard]] virtual size_t getCount() const = 0;
-    [[nodiscard]] virtual VkDescriptorSet getDescriptorSet(size_t imageIndex) const = 0;
+    [[nodiscard]] virtual VkDescriptorSet getDescriptorSet(size_t frameIndex) const = 0;
     [[nodiscard]] size_t getTotalSize() const { return getStride() * getCount(); }
 
-    virtual void updateGpuBuffer(
+    /**
+     * Stages the data that changed since the last upload to frameIndex in the upload ring and records the copies into
+     * the GPU buffer of frameIndex into commandBuffer. The barrier that makes the copies visible to the shaders is
+     * appended to barriers and recorded by the caller for all buffers at once.
+     */
+    virtual void recordUpload(
         VkCommandBuffer commandBuffer,
-        VkQueue queue,
-        size_t imageIndex) const = 0;
+        size_t frameIndex,
+        UploadRing& uploadRing,
+        std::vector<VkBufferMemoryBarrier>& barriers) = 0;
 };
 
 #endif //IGENERICBUFFERINTERFACE_H
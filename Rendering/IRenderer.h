@@ -0,0 +1,107 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef IRENDERER_H
+#define IRENDERER_H
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "AssetManager.h"
+#include "DrawRequest.h"
+#include "IGenericBuffer.h"
+#include "ObjectBuffer.h"
+#include "../Core/Camera.h"
+#include "../Core/Map.h"
+#include "../include/imgui/imgui.h"
+
+/**
+ * What the game needs from a renderer. The object buffers live here, so the game fills instance data the same way
+ * regardless of the backend. Backends without a device hand out buffers that only keep the data on the CPU.
+ */
+class IRenderer
+{
+public:
+    virtual ~IRenderer() = default;
+
+    /**
+     * Only records the shaders, the pipeline is created by the next createPipelines. Returns the pipeline index.
+     */
+    virtual size_t registerShader(
+        const std::filesystem::path& vertexShaderPath,
+        const std::filesystem::path& fragmentShaderPath,
+        size_t dataBufferIndex,
+        bool gpuCulled = false) = 0;
+
+    virtual void createPipelines() = 0;
+
+    /**
+     * Returns the texture index of every entry, for getFrameIndex, in the order of the entries.
+     */
+    virtual std::vector<size_t> loadAtlas(const LoadedAtlas& atlas) = 0;
+
+    /**
+     * Index into the frame table that instances reference their frame by.
+     */
+    [[nodiscard]] virtual uint32_t getFrameIndex(size_t textureIndex, size_t frame) = 0;
+
+    /**
+     * The map is drawn below all draw requests.
+     */
+    virtual void updateTilemap(const Map& map) = 0;
+
+    /**
+     * Draws drawRequests sorted by layer and order in layer. The requests are only read during the call, the caller
+     * keeps ownership of its list.
+     */
+    virtual void drawScene(
+        const Camera& camera,
+        std::span<const DrawRequest> drawRequests,
+        ImDrawData* uiData) = 0;
+
+    /**
+     * Whether instances are frustum culled on the GPU, so the caller can submit every object and leave the instance
+     * data of unchanged objects alone.
+     */
+    [[nodiscard]] virtual bool isGpuCullingActive() const = 0;
+
+    template<typename T>
+    size_t registerDataType(size_t initialSize)
+    {
+        m_objectBuffers.emplace_back(
+            std::make_unique<ObjectBuffer<T>>(
+                getObjectBufferResources(),
+                getObjectBufferFrames(),
+                initialSize));
+        return m_objectBuffers.size() - 1;
+    }
+
+    template<typename T>
+    ObjectBuffer<T>& getDataBuffer(size_t index)
+    {
+        IGenericBuffer& reference = *m_objectBuffers[index];
+        return static_cast<ObjectBuffer<T>&>(reference);
+    }
+
+    template<typename T>
+    const ObjectBuffer<T>& getDataBuffer(size_t index) const
+    {
+        const IGenericBuffer& reference = *m_objectBuffers[index];
+        return static_cast<const ObjectBuffer<T>&>(reference);
+    }
+
+protected:
+    std::vector<std::unique_ptr<IGenericBuffer>> m_objectBuffers{};
+
+    /**
+     * Object buffers created with expired resources never allocate GPU buffers or descriptor sets.
+     */
+    [[nodiscard]] virtual std::weak_ptr<VulkanResources> getObjectBufferResources() const = 0;
+    [[nodiscard]] virtual size_t getObjectBufferFrames() const = 0;
+};
+
+#endif //IRENDERER_H
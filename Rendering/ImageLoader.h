@@ -5,7 +5,6 @@
 #ifndef IMAGELOADER_H
 #define IMAGELOADER_H
 
-#define STB_IMAGE_IMPLEMENTATION
 #include <filesystem>
 #include <stdexcept>
 
@@ -0,0 +1,271 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include "Logger.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace
+{
+    static_assert((Logger::QUEUE_CAPACITY & (Logger::QUEUE_CAPACITY - 1)) == 0, "capacity has to be a power of two");
+
+    constexpr auto IDLE_SLEEP = std::chrono::milliseconds(1);
+
+    typedef struct
+    {
+        // Equals the position a producer may write next, position plus one once the record is written
+        std::atomic<uint64_t> sequence;
+        LogRecord record;
+    } QueueSlot;
+
+    /**
+     * Bounded multi producer queue with one sequence number per slot, only the writer thread consumes.
+     */
+    class LogQueue
+    {
+    public:
+        LogQueue()
+        {
+            m_slots = std::make_unique<QueueSlot[]>(Logger::QUEUE_CAPACITY);
+
+            for (uint64_t i = 0; i < Logger::QUEUE_CAPACITY; i++)
+            {
+                m_slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        bool push(const LogRecord& record)
+        {
+            uint64_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+
+            while (true)
+            {
+                QueueSlot& slot = m_slots[position & (Logger::QUEUE_CAPACITY - 1)];
+                const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<int64_t>(sequence - position);
+
+                if (difference == 0)
+                {
+                    if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        slot.record = record;
+                        slot.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    // The writer has not consumed this slot from the previous lap yet
+                    return false;
+                }
+                else
+                {
+                    position = m_enqueuePosition.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool pop(LogRecord& record)
+        {
+            const uint64_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+            QueueSlot& slot = m_slots[position & (Logger::QUEUE_CAPACITY - 1)];
+
+            if (slot.sequence.load(std::memory_order_acquire) != position + 1)
+            {
+                return false;
+            }
+
+            record = slot.record;
+            slot.sequence.store(position + Logger::QUEUE_CAPACITY, std::memory_order_release);
+            m_dequeuePosition.store(position + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        [[nodiscard]] uint64_t getEnqueuePosition() const { return m_enqueuePosition.load(std::memory_order_acquire); }
+        [[nodiscard]] uint64_t getDequeuePosition() const { return m_dequeuePosition.load(std::memory_order_relaxed); }
+
+    private:
+        std::unique_ptr<QueueSlot[]> m_slots;
+        std::atomic<uint64_t> m_enqueuePosition{0};
+        std::atomic<uint64_t> m_dequeuePosition{0};
+    };
+
+    const char* getLevelName(LogLevel level)
+    {
+        switch (level)
+        {
+            case LogLevel::Debug: return "Debug";
+            case LogLevel::Info: return "Info";
+            case LogLevel::Warning: return "Warning";
+            case LogLevel::Error: return "Error";
+        }
+
+        return "";
+    }
+
+    void appendArgument(std::string& line, const LogRecord& record, const LogArgument& argument)
+    {
+        char buffer[32];
+
+        switch (argument.type)
+        {
+            case LogArgumentType::Signed:
+                std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(argument.signedValue));
+                break;
+
+            case LogArgumentType::Unsigned:
+                std::snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(argument.unsignedValue));
+                break;
+
+            case LogArgumentType::Floating:
+                std::snprintf(buffer, sizeof(buffer), "%.3f", argument.floatingValue);
+                break;
+
+            case LogArgumentType::String:
+                line += argument.stringValue ? argument.stringValue : "(null)";
+                return;
+
+            case LogArgumentType::Text:
+                line += record.text + argument.textOffset;
+                return;
+        }
+
+        line += buffer;
+    }
+
+    void formatRecord(std::string& line, const LogRecord& record)
+    {
+        line += '[';
+        line += getLevelName(record.level);
+        line += "][";
+        line += record.category;
+        line += "] ";
+
+        size_t argument = 0;
+
+        for (const char* c = record.format; *c != '\0'; c++)
+        {
+            if (c[0] == '{' && c[1] == '}' && argument < record.argumentCount)
+            {
+                appendArgument(line, record, record.arguments[argument++]);
+                c++;
+                continue;
+            }
+
+            line += *c;
+        }
+
+        line += '\n';
+    }
+
+    class LoggerState
+    {
+    public:
+        LogQueue queue{};
+        std::atomic<LogLevel> level{LogLevel::Info};
+        std::atomic<uint64_t> droppedCount{0};
+        // Queue position up to which every record is written to std::cout
+        std::atomic<uint64_t> writtenPosition{0};
+
+        LoggerState()
+        {
+            m_writer = std::jthread([this](const std::stop_token& stopToken) { write(stopToken); });
+        }
+
+    private:
+        std::jthread m_writer;
+
+        void write(const std::stop_token& stopToken)
+        {
+            std::string lines{};
+            LogRecord record{};
+            uint64_t reportedDrops = 0;
+
+            while (true)
+            {
+                // Checked before draining, so records logged before the stop request are still written
+                const bool stopping = stopToken.stop_requested();
+                lines.clear();
+
+                while (queue.pop(record))
+                {
+                    formatRecord(lines, record);
+                }
+
+                const uint64_t dequeuePosition = queue.getDequeuePosition();
+                const uint64_t drops = droppedCount.load(std::memory_order_relaxed);
+
+                if (drops != reportedDrops)
+                {
+                    lines += "[Warning][Log] Dropped " + std::to_string(drops - reportedDrops) +
+                        " records, the queue was full\n";
+                    reportedDrops = drops;
+                }
+
+                if (!lines.empty())
+                {
+                    std::cout << lines;
+                    std::cout.flush();
+                    writtenPosition.store(dequeuePosition, std::memory_order_release);
+                }
+                else if (stopping)
+                {
+                    return;
+                }
+                else
+                {
+                    std::this_thread::sleep_for(IDLE_SLEEP);
+                }
+            }
+        }
+    };
+
+    LoggerState& getState()
+    {
+        static LoggerState state{};
+        return state;
+    }
+}
+
+void Logger::setLevel(LogLevel level)
+{
+    getState().level.store(level, std::memory_order_relaxed);
+}
+
+bool Logger::isEnabled(LogLevel level)
+{
+    return level >= getState().level.load(std::memory_order_relaxed);
+}
+
+void Logger::flush()
+{
+    LoggerState& state = getState();
+    const uint64_t target = state.queue.getEnqueuePosition();
+
+    while (state.writtenPosition.load(std::memory_order_acquire) < target)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+uint64_t Logger::getDroppedCount()
+{
+    return getState().droppedCount.load(std::memory_order_relaxed);
+}
+
+void Logger::push(const LogRecord& record)
+{
+    LoggerState& state = getState();
+
+    if (!state.queue.push(record))
+    {
+        state.droppedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,188 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+enum class LogLevel : uint8_t
+{
+    Debug,
+    Info,
+    Warning,
+    Error
+};
+
+enum class LogArgumentType : uint8_t
+{
+    Signed,
+    Unsigned,
+    Floating,
+    String,
+    // Copied into the text of the record
+    Text
+};
+
+typedef struct
+{
+    LogArgumentType type;
+
+    union
+    {
+        int64_t signedValue;
+        uint64_t unsignedValue;
+        double floatingValue;
+        const char* stringValue;
+        uint16_t textOffset;
+    };
+} LogArgument;
+
+typedef struct
+{
+    LogLevel level;
+    uint8_t argumentCount;
+    const char* category;
+    const char* format;
+    uint16_t textLength;
+    LogArgument arguments[6];
+    char text[160];
+} LogRecord;
+
+/**
+ * Logs from any thread without locking or formatting on the calling thread. A call copies the format string pointer
+ * and its arguments as binary values into a bounded lock-free queue, a background thread formats and writes them to
+ * std::cout. Each {} in the format is replaced by the next argument.
+ * When the queue is full the record is dropped and counted instead of blocking the caller.
+ * Format, category and const char* arguments are not copied and have to outlive the record, usually string literals.
+ * std::string, std::string_view and path arguments are copied into the record and cut off at MAX_TEXT_LENGTH bytes.
+ */
+class Logger
+{
+public:
+    static constexpr size_t QUEUE_CAPACITY = 4096;
+    static constexpr size_t MAX_ARGUMENTS = std::extent_v<decltype(LogRecord::arguments)>;
+    static constexpr size_t MAX_TEXT_LENGTH = std::extent_v<decltype(LogRecord::text)> - 1;
+
+    /**
+     * Records below level are discarded on the calling thread. Info by default.
+     */
+    static void setLevel(LogLevel level);
+
+    [[nodiscard]] static bool isEnabled(LogLevel level);
+
+    template<typename... Arguments>
+    static void log(LogLevel level, const char* category, const char* format, const Arguments&... arguments)
+    {
+        static_assert(sizeof...(Arguments) <= MAX_ARGUMENTS, "too many log arguments");
+
+        if (!isEnabled(level))
+        {
+            return;
+        }
+
+        LogRecord record;
+        record.level = level;
+        record.argumentCount = static_cast<uint8_t>(sizeof...(Arguments));
+        record.category = category;
+        record.format = format;
+        record.textLength = 0;
+
+        size_t index = 0;
+        ((record.arguments[index++] = makeArgument(record, arguments)), ...);
+
+        push(record);
+    }
+
+    /**
+     * Blocks until every record logged before the call is written.
+     */
+    static void flush();
+
+    [[nodiscard]] static uint64_t getDroppedCount();
+
+private:
+    static void push(const LogRecord& record);
+
+    static LogArgument makeTextArgument(LogRecord& record, std::string_view text)
+    {
+        LogArgument argument{};
+        argument.type = LogArgumentType::Text;
+        argument.textOffset = record.textLength;
+
+        const size_t length = std::min(text.size(), MAX_TEXT_LENGTH - record.textLength);
+        std::memcpy(record.text + record.textLength, text.data(), length);
+        record.textLength = static_cast<uint16_t>(record.textLength + length);
+        record.text[record.textLength] = '\0';
+
+        // Every copied argument is terminated, a cut off argument takes the terminator slot of the buffer
+        if (record.textLength < MAX_TEXT_LENGTH)
+        {
+            record.textLength++;
+        }
+
+        return argument;
+    }
+
+    template<typename Argument>
+    static LogArgument makeArgument(LogRecord& record, const Argument& argumentValue)
+    {
+        using T = std::decay_t<Argument>;
+        LogArgument argument{};
+
+        if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*>)
+        {
+            argument.type = LogArgumentType::String;
+            argument.stringValue = argumentValue;
+        }
+        else if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>)
+        {
+            return makeTextArgument(record, argumentValue);
+        }
+        else if constexpr (std::is_same_v<T, std::filesystem::path>)
+        {
+            return makeTextArgument(record, argumentValue.string());
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            argument.type = LogArgumentType::Floating;
+            argument.floatingValue = static_cast<double>(argumentValue);
+        }
+        else if constexpr (std::is_signed_v<T>)
+        {
+            argument.type = LogArgumentType::Signed;
+            argument.signedValue = static_cast<int64_t>(argumentValue);
+        }
+        else
+        {
+            static_assert(std::is_unsigned_v<T>, "log arguments have to be numbers or strings");
+            argument.type = LogArgumentType::Unsigned;
+            argument.unsignedValue = static_cast<uint64_t>(argumentValue);
+        }
+
+        return argument;
+    }
+};
+
+/**
+ * Only logs every nth call of this call site, for call sites that run once per frame.
+ */
+#define LOG_EVERY_N(n, level, category, ...) \
+    do \
+    { \
+        static std::atomic<uint64_t> logEveryCounter{0}; \
+        if (logEveryCounter.fetch_add(1, std::memory_order_relaxed) % (n) == 0) \
+        { \
+            Logger::log(level, category, __VA_ARGS__); \
+        } \
+    } while (false)
+
+#endif //LOGGER_H
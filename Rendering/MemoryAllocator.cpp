@@ -0,0 +1,467 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include "MemoryAllocator.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "VulkanHelpers.h"
+
+static uint32_t floorLog2(VkDeviceSize value)
+{
+    uint32_t result = 0;
+
+    while (value > 1)
+    {
+        value >>= 1;
+        result++;
+    }
+
+    return result;
+}
+
+static VkDeviceSize nextPowerOfTwo(VkDeviceSize value)
+{
+    VkDeviceSize result = 1;
+
+    while (result < value)
+    {
+        result <<= 1;
+    }
+
+    return result;
+}
+
+static VkDeviceSize previousPowerOfTwo(VkDeviceSize value)
+{
+    VkDeviceSize result = 1;
+
+    while (result <= value / 2)
+    {
+        result <<= 1;
+    }
+
+    return result;
+}
+
+MemoryBlock::MemoryBlock(
+    VkDevice device,
+    const VkAllocationCallbacks* allocator,
+    uint32_t memoryTypeIndex,
+    VkMemoryPropertyFlags properties,
+    VkDeviceSize size,
+    bool linear)
+{
+    m_device = device;
+    m_allocator = allocator;
+    m_memoryTypeIndex = memoryTypeIndex;
+    m_properties = properties;
+    m_size = size;
+    m_linear = linear;
+
+    VkMemoryAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+    if (vkAllocateMemory(device, &allocInfo, allocator, &m_memory) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to allocate memory block");
+    }
+
+    if (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        if (vkMapMemory(device, m_memory, 0, VK_WHOLE_SIZE, 0, &m_mappedData) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to map memory block");
+        }
+    }
+
+    const uint32_t maxLevel = floorLog2(size / MIN_ALLOCATION_SIZE);
+    m_freeLists.resize(maxLevel + 1);
+    m_freeLists[maxLevel].insert(0);
+}
+
+MemoryBlock::~MemoryBlock()
+{
+    if (m_mappedData)
+    {
+        vkUnmapMemory(m_device, m_memory);
+    }
+
+    vkFreeMemory(m_device, m_memory, m_allocator);
+}
+
+bool MemoryBlock::tryAllocate(VkDeviceSize size, VkDeviceSize alignment, MemoryAllocation& allocation)
+{
+    const VkDeviceSize rangeSize = nextPowerOfTwo(std::max({ size, alignment, MIN_ALLOCATION_SIZE }));
+
+    if (rangeSize > m_size)
+    {
+        return false;
+    }
+
+    const uint32_t level = floorLog2(rangeSize / MIN_ALLOCATION_SIZE);
+    uint32_t freeLevel = level;
+
+    while (freeLevel < m_freeLists.size() && m_freeLists[freeLevel].empty())
+    {
+        freeLevel++;
+    }
+
+    if (freeLevel >= m_freeLists.size())
+    {
+        return false;
+    }
+
+    const VkDeviceSize offset = *m_freeLists[freeLevel].begin();
+    m_freeLists[freeLevel].erase(m_freeLists[freeLevel].begin());
+
+    // Split the found range until it has the requested size, the upper halves stay free
+    while (freeLevel > level)
+    {
+        freeLevel--;
+        m_freeLists[freeLevel].insert(offset + getLevelSize(freeLevel));
+    }
+
+    m_usedBytes += rangeSize;
+
+    allocation.memory = m_memory;
+    allocation.offset = offset;
+    allocation.size = rangeSize;
+    allocation.memoryTypeIndex = m_memoryTypeIndex;
+    allocation.properties = m_properties;
+    allocation.mappedData = m_mappedData ? static_cast<char*>(m_mappedData) + offset : nullptr;
+    allocation.block = this;
+    allocation.level = level;
+
+    return true;
+}
+
+void MemoryBlock::free(const MemoryAllocation& allocation)
+{
+    VkDeviceSize offset = allocation.offset;
+    uint32_t level = allocation.level;
+
+    // Merge with the buddy as long as it is free as well
+    while (level + 1 < m_freeLists.size())
+    {
+        const VkDeviceSize buddy = offset ^ getLevelSize(level);
+        const auto buddyIterator = m_freeLists[level].find(buddy);
+
+        if (buddyIterator == m_freeLists[level].end())
+        {
+            break;
+        }
+
+        m_freeLists[level].erase(buddyIterator);
+        offset = std::min(offset, buddy);
+        level++;
+    }
+
+    m_freeLists[level].insert(offset);
+    m_usedBytes -= getLevelSize(allocation.level);
+}
+
+MemoryAllocator::MemoryAllocator(
+    VkPhysicalDevice physicalDevice,
+    VkDevice device,
+    const VkAllocationCallbacks* allocator,
+    VkDeviceSize preferredBlockSize)
+{
+    m_device = device;
+    m_allocator = allocator;
+
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &m_memoryProperties);
+
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    m_nonCoherentAtomSize = properties.limits.nonCoherentAtomSize;
+
+    // Small heaps, like the 256 MiB BAR window without ReBAR, get smaller blocks to not waste most of the heap
+    m_blockSizes.resize(m_memoryProperties.memoryHeapCount);
+
+    for (uint32_t i = 0; i < m_memoryProperties.memoryHeapCount; i++)
+    {
+        const VkDeviceSize heapSize = m_memoryProperties.memoryHeaps[i].size;
+        m_blockSizes[i] = previousPowerOfTwo(std::min(preferredBlockSize, heapSize / 8));
+    }
+}
+
+MemoryAllocator::~MemoryAllocator()
+{
+    m_blocks.clear();
+}
+
+uint32_t MemoryAllocator::findMemoryType(
+    uint32_t typeFilter,
+    VkMemoryPropertyFlags required,
+    VkMemoryPropertyFlags preferred) const
+{
+    if (preferred != 0)
+    {
+        const auto preferredType = VulkanHelpers::tryFindMemoryType(
+            m_memoryProperties,
+            typeFilter,
+            required | preferred);
+
+        if (preferredType.has_value())
+        {
+            return preferredType.value();
+        }
+    }
+
+    const auto requiredType = VulkanHelpers::tryFindMemoryType(m_memoryProperties, typeFilter, required);
+
+    if (!requiredType.has_value())
+    {
+        throw std::runtime_error("Failed to find suitable memory type");
+    }
+
+    return requiredType.value();
+}
+
+MemoryAllocation MemoryAllocator::allocateForBuffer(
+    VkBuffer buffer,
+    VkMemoryPropertyFlags required,
+    VkMemoryPropertyFlags preferred)
+{
+    VkMemoryDedicatedRequirements dedicatedRequirements{ VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS };
+    VkMemoryRequirements2 requirements{ VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2 };
+    requirements.pNext = &dedicatedRequirements;
+
+    VkBufferMemoryRequirementsInfo2 requirementsInfo{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2 };
+    requirementsInfo.buffer = buffer;
+
+    vkGetBufferMemoryRequirements2(m_device, &requirementsInfo, &requirements);
+
+    VkMemoryDedicatedAllocateInfo dedicatedInfo{ VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO };
+    dedicatedInfo.buffer = buffer;
+
+    const MemoryAllocation allocation = allocate(
+        requirements.memoryRequirements,
+        required,
+        preferred,
+        true,
+        dedicatedRequirements.prefersDedicatedAllocation || dedicatedRequirements.requiresDedicatedAllocation,
+        &dedicatedInfo);
+
+    if (vkBindBufferMemory(m_device, buffer, allocation.memory, allocation.offset) != VK_SUCCESS)
+    {
+        free(allocation);
+        throw std::runtime_error("Failed to bind buffer memory");
+    }
+
+    return allocation;
+}
+
+MemoryAllocation MemoryAllocator::allocateForImage(
+    VkImage image,
+    VkMemoryPropertyFlags required,
+    VkMemoryPropertyFlags preferred)
+{
+    VkMemoryDedicatedRequirements dedicatedRequirements{ VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS };
+    VkMemoryRequirements2 requirements{ VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2 };
+    requirements.pNext = &dedicatedRequirements;
+
+    VkImageMemoryRequirementsInfo2 requirementsInfo{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2 };
+    requirementsInfo.image = image;
+
+    vkGetImageMemoryRequirements2(m_device, &requirementsInfo, &requirements);
+
+    VkMemoryDedicatedAllocateInfo dedicatedInfo{ VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO };
+    dedicatedInfo.image = image;
+
+    const MemoryAllocation allocation = allocate(
+        requirements.memoryRequirements,
+        required,
+        preferred,
+        false,
+        dedicatedRequirements.prefersDedicatedAllocation || dedicatedRequirements.requiresDedicatedAllocation,
+        &dedicatedInfo);
+
+    if (vkBindImageMemory(m_device, image, allocation.memory, allocation.offset) != VK_SUCCESS)
+    {
+        free(allocation);
+        throw std::runtime_error("Failed to bind image memory");
+    }
+
+    return allocation;
+}
+
+MemoryAllocation MemoryAllocator::allocate(
+    const VkMemoryRequirements& requirements,
+    VkMemoryPropertyFlags required,
+    VkMemoryPropertyFlags preferred,
+    bool linear,
+    bool dedicated,
+    const VkMemoryDedicatedAllocateInfo* dedicatedInfo)
+{
+    const uint32_t memoryTypeIndex = findMemoryType(requirements.memoryTypeBits, required, preferred);
+    const uint32_t heapIndex = m_memoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+    const VkDeviceSize blockSize = m_blockSizes[heapIndex];
+
+    std::lock_guard lock(m_mutex);
+
+    if (dedicated || requirements.size > blockSize / 2)
+    {
+        return allocateDedicated(requirements, memoryTypeIndex, dedicatedInfo);
+    }
+
+    MemoryAllocation allocation{};
+
+    for (const auto& block : m_blocks)
+    {
+        if (block->getMemoryTypeIndex() == memoryTypeIndex &&
+            block->isLinear() == linear &&
+            block->tryAllocate(requirements.size, requirements.alignment, allocation))
+        {
+            m_allocationCount++;
+            return allocation;
+        }
+    }
+
+    m_blocks.emplace_back(
+        std::make_unique<MemoryBlock>(
+            m_device,
+            m_allocator,
+            memoryTypeIndex,
+            m_memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags,
+            blockSize,
+            linear));
+
+    if (!m_blocks.back()->tryAllocate(requirements.size, requirements.alignment, allocation))
+    {
+        throw std::runtime_error("Failed to allocate from new memory block");
+    }
+
+    m_allocationCount++;
+    return allocation;
+}
+
+MemoryAllocation MemoryAllocator::allocateDedicated(
+    const VkMemoryRequirements& requirements,
+    uint32_t memoryTypeIndex,
+    const VkMemoryDedicatedAllocateInfo* dedicatedInfo)
+{
+    MemoryAllocation allocation{};
+    allocation.size = requirements.size;
+    allocation.memoryTypeIndex = memoryTypeIndex;
+    allocation.properties = m_memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
+
+    VkMemoryAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+    allocInfo.pNext = dedicatedInfo;
+    allocInfo.allocationSize = requirements.size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+    if (vkAllocateMemory(m_device, &allocInfo, m_allocator, &allocation.memory) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to allocate dedicated memory");
+    }
+
+    if (allocation.properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        if (vkMapMemory(m_device, allocation.memory, 0, VK_WHOLE_SIZE, 0, &allocation.mappedData) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to map dedicated memory");
+        }
+    }
+
+    m_dedicatedAllocationCount++;
+    m_dedicatedBytes += requirements.size;
+    m_allocationCount++;
+
+    return allocation;
+}
+
+void MemoryAllocator::free(const MemoryAllocation& allocation)
+{
+    if (allocation.memory == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    std::lock_guard lock(m_mutex);
+    m_allocationCount--;
+
+    if (!allocation.block)
+    {
+        if (allocation.mappedData)
+        {
+            vkUnmapMemory(m_device, allocation.memory);
+        }
+
+        vkFreeMemory(m_device, allocation.memory, m_allocator);
+        m_dedicatedAllocationCount--;
+        m_dedicatedBytes -= allocation.size;
+        return;
+    }
+
+    MemoryBlock* block = allocation.block;
+    block->free(allocation);
+
+    if (!block->isEmpty())
+    {
+        return;
+    }
+
+    // Keep one empty block per memory type around so alternating allocations do not hit the driver every time
+    const auto sameKind = std::ranges::count_if(m_blocks, [block](const auto& other)
+    {
+        return other->getMemoryTypeIndex() == block->getMemoryTypeIndex() && other->isLinear() == block->isLinear();
+    });
+
+    if (sameKind > 1)
+    {
+        std::erase_if(m_blocks, [block](const auto& other) { return other.get() == block; });
+    }
+}
+
+void MemoryAllocator::flush(const MemoryAllocation& allocation, VkDeviceSize offset, VkDeviceSize size) const
+{
+    if (!allocation.mappedData || (allocation.properties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+    {
+        return;
+    }
+
+    const VkDeviceSize start = allocation.offset + offset;
+    const VkDeviceSize length = size == VK_WHOLE_SIZE ? allocation.size - offset : size;
+
+    VkMappedMemoryRange range{ VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE };
+    range.memory = allocation.memory;
+    range.offset = VulkanHelpers::alignDown(start, m_nonCoherentAtomSize);
+
+    const VkDeviceSize end = VulkanHelpers::alignUp(start + length, m_nonCoherentAtomSize);
+    const VkDeviceSize memoryEnd = allocation.block ? allocation.block->getSize() : allocation.size;
+
+    // The end of the memory object does not have to be a multiple of the atom size
+    range.size = end >= memoryEnd ? VK_WHOLE_SIZE : end - range.offset;
+
+    if (vkFlushMappedMemoryRanges(m_device, 1, &range) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to flush mapped memory");
+    }
+}
+
+MemoryStatistics MemoryAllocator::getStatistics() const
+{
+    std::lock_guard lock(m_mutex);
+
+    MemoryStatistics statistics
+    {
+        m_blocks.size(),
+        m_dedicatedAllocationCount,
+        m_allocationCount,
+        m_dedicatedBytes,
+        m_dedicatedBytes
+    };
+
+    for (const auto& block : m_blocks)
+    {
+        statistics.allocatedBytes += block->getSize();
+        statistics.usedBytes += block->getUsedBytes();
+    }
+
+    return statistics;
+}
@@ -0,0 +1,156 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef MEMORYALLOCATOR_H
+#define MEMORYALLOCATOR_H
+
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+class MemoryBlock;
+
+typedef struct
+{
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+    uint32_t memoryTypeIndex = 0;
+    VkMemoryPropertyFlags properties = 0;
+    void* mappedData = nullptr;
+
+    MemoryBlock* block = nullptr;
+    uint32_t level = 0;
+} MemoryAllocation;
+
+typedef struct
+{
+    size_t blockCount;
+    size_t dedicatedAllocationCount;
+    size_t allocationCount;
+    VkDeviceSize allocatedBytes;
+    VkDeviceSize usedBytes;
+} MemoryStatistics;
+
+/**
+ * Power of two sized block of device memory that hands out sub ranges with a buddy allocator.
+ * Every range is aligned to its own size, which covers the alignment requirements of buffers and images.
+ */
+class MemoryBlock
+{
+public:
+    static constexpr VkDeviceSize MIN_ALLOCATION_SIZE = 256;
+
+    MemoryBlock(
+        VkDevice device,
+        const VkAllocationCallbacks* allocator,
+        uint32_t memoryTypeIndex,
+        VkMemoryPropertyFlags properties,
+        VkDeviceSize size,
+        bool linear);
+    ~MemoryBlock();
+
+    bool tryAllocate(VkDeviceSize size, VkDeviceSize alignment, MemoryAllocation& allocation);
+    void free(const MemoryAllocation& allocation);
+
+    [[nodiscard]] bool isEmpty() const { return m_usedBytes == 0; }
+    [[nodiscard]] bool isLinear() const { return m_linear; }
+    [[nodiscard]] uint32_t getMemoryTypeIndex() const { return m_memoryTypeIndex; }
+    [[nodiscard]] VkDeviceSize getSize() const { return m_size; }
+    [[nodiscard]] VkDeviceSize getUsedBytes() const { return m_usedBytes; }
+
+private:
+    VkDevice m_device = VK_NULL_HANDLE;
+    const VkAllocationCallbacks* m_allocator = nullptr;
+    VkDeviceMemory m_memory = VK_NULL_HANDLE;
+    VkMemoryPropertyFlags m_properties = 0;
+    uint32_t m_memoryTypeIndex = 0;
+    VkDeviceSize m_size = 0;
+    VkDeviceSize m_usedBytes = 0;
+    bool m_linear = true;
+    void* m_mappedData = nullptr;
+
+    // Free offsets per level, level 0 holds MIN_ALLOCATION_SIZE ranges
+    std::vector<std::set<VkDeviceSize>> m_freeLists{};
+
+    [[nodiscard]] VkDeviceSize getLevelSize(uint32_t level) const { return MIN_ALLOCATION_SIZE << level; }
+};
+
+/**
+ * Sub-allocates buffers and images from large blocks per memory type instead of one vkAllocateMemory per resource.
+ * Buffers and optimally tiled images never share a block, so bufferImageGranularity does not need to be considered.
+ * Resources larger than half a block, or that the driver prefers to be dedicated, get their own allocation.
+ * Host visible memory is mapped once per block and stays mapped.
+ */
+class MemoryAllocator
+{
+public:
+    static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 64 * 1024 * 1024;
+
+    MemoryAllocator(
+        VkPhysicalDevice physicalDevice,
+        VkDevice device,
+        const VkAllocationCallbacks* allocator,
+        VkDeviceSize preferredBlockSize = DEFAULT_BLOCK_SIZE);
+    ~MemoryAllocator();
+
+    /**
+     * Allocates and binds memory for buffer. The memory type has all of required and, if such a type exists,
+     * all of preferred as well.
+     */
+    MemoryAllocation allocateForBuffer(
+        VkBuffer buffer,
+        VkMemoryPropertyFlags required,
+        VkMemoryPropertyFlags preferred = 0);
+
+    MemoryAllocation allocateForImage(
+        VkImage image,
+        VkMemoryPropertyFlags required,
+        VkMemoryPropertyFlags preferred = 0);
+
+    void free(const MemoryAllocation& allocation);
+
+    /**
+     * Makes host writes to the range of the allocation visible to the device. No-op for host coherent memory.
+     */
+    void flush(const MemoryAllocation& allocation, VkDeviceSize offset, VkDeviceSize size) const;
+
+    [[nodiscard]] MemoryStatistics getStatistics() const;
+    [[nodiscard]] VkDeviceSize getNonCoherentAtomSize() const { return m_nonCoherentAtomSize; }
+
+private:
+    VkDevice m_device = VK_NULL_HANDLE;
+    const VkAllocationCallbacks* m_allocator = nullptr;
+    VkPhysicalDeviceMemoryProperties m_memoryProperties{};
+    VkDeviceSize m_nonCoherentAtomSize = 1;
+    std::vector<VkDeviceSize> m_blockSizes{};
+
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<MemoryBlock>> m_blocks{};
+    size_t m_dedicatedAllocationCount = 0;
+    size_t m_allocationCount = 0;
+    VkDeviceSize m_dedicatedBytes = 0;
+
+    [[nodiscard]] uint32_t findMemoryType(
+        uint32_t typeFilter,
+        VkMemoryPropertyFlags required,
+        VkMemoryPropertyFlags preferred) const;
+
+    MemoryAllocation allocate(
+        const VkMemoryRequirements& requirements,
+        VkMemoryPropertyFlags required,
+        VkMemoryPropertyFlags preferred,
+        bool linear,
+        bool dedicated,
+        const VkMemoryDedicatedAllocateInfo* dedicatedInfo);
+
+    MemoryAllocation allocateDedicated(
+        const VkMemoryRequirements& requirements,
+        uint32_t memoryTypeIndex,
+        const VkMemoryDedicatedAllocateInfo* dedicatedInfo);
+};
+
+#endif //MEMORYALLOCATOR_H
@@ -0,0 +1,84 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include "NullRenderer.h"
+
+#include <algorithm>
+
+#include "CpuProfiler.h"
+
+size_t NullRenderer::registerShader(
+    [[maybe_unused]] const std::filesystem::path& vertexShaderPath,
+    [[maybe_unused]] const std::filesystem::path& fragmentShaderPath,
+    size_t dataBufferIndex,
+    [[maybe_unused]] bool gpuCulled)
+{
+    m_pipelineDataBuffers.push_back(dataBufferIndex);
+    m_statistics.pipelines = m_pipelineDataBuffers.size();
+
+    return m_pipelineDataBuffers.size() - 1;
+}
+
+std::vector<size_t> NullRenderer::loadAtlas(const LoadedAtlas& atlas)
+{
+    std::vector<size_t> textureIndices{};
+    textureIndices.reserve(atlas.entries.size());
+
+    for (const auto& entry : atlas.entries)
+    {
+        textureIndices.push_back(m_textureFirstFrames.size());
+        m_textureFirstFrames.push_back(m_frameCount);
+        // Entries without frames still get one, like in VulkanRenderer, so frame indices match between the backends
+        m_frameCount += static_cast<uint32_t>(std::max<size_t>(entry.frames.size(), 1));
+    }
+
+    m_statistics.frameTableEntries = m_frameCount;
+
+    return textureIndices;
+}
+
+void NullRenderer::updateTilemap(const Map& map)
+{
+    if (map.getRevision() != m_mapRevision)
+    {
+        m_mapRevision = map.getRevision();
+        m_statistics.tilemapUpdates++;
+    }
+}
+
+void NullRenderer::drawScene(
+    [[maybe_unused]] const Camera& camera,
+    std::span<const DrawRequest> drawRequests,
+    [[maybe_unused]] ImDrawData* uiData)
+{
+    PROFILE_SCOPE("Sort");
+    m_drawKeys.clear();
+
+    for (const auto& drawRequest : drawRequests)
+    {
+        m_drawKeys.push_back(DrawKey::pack(drawRequest));
+    }
+
+    DrawKey::sort(m_drawKeys, m_drawKeysScratch);
+    DrawKey::buildBatches(m_drawKeys, m_drawBatches);
+
+    if (m_recordingEnabled)
+    {
+        // One draw per batch, like VulkanRenderer records them
+        for (const auto& batch : m_drawBatches)
+        {
+            m_commandStream.push_back({
+                m_statistics.frames,
+                batch.pipelineIndex,
+                DrawKey::getLayer(m_drawKeys[batch.firstKey]),
+                static_cast<uint32_t>(batch.firstKey),
+                static_cast<uint32_t>(batch.lastKey - batch.firstKey + 1)
+            });
+        }
+    }
+
+    m_statistics.frames++;
+    m_statistics.drawRequests += drawRequests.size();
+    m_statistics.drawCalls += m_drawBatches.size();
+}
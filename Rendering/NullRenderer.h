@@ -0,0 +1,103 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef NULLRENDERER_H
+#define NULLRENDERER_H
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include "DrawKey.h"
+#include "IRenderer.h"
+
+typedef struct
+{
+    uint64_t frames;
+    uint64_t drawRequests;
+    uint64_t drawCalls;
+    uint64_t tilemapUpdates;
+    size_t pipelines;
+    size_t frameTableEntries;
+} NullRendererStatistics;
+
+typedef struct
+{
+    uint64_t frame;
+    size_t pipelineIndex;
+    uint32_t layer;
+    uint32_t firstInstance;
+    uint32_t instanceCount;
+} RecordedDraw;
+
+/**
+ * Renderer without a device, for measuring the game loop on the CPU. drawScene sorts and batches the draw requests
+ * like VulkanRenderer does and counts the draws it would record, nothing is uploaded or submitted.
+ * Object buffers only keep their data on the CPU and atlases only number their frames, no textures are created.
+ */
+class NullRenderer : public IRenderer
+{
+public:
+    NullRenderer() = default;
+
+    size_t registerShader(
+        const std::filesystem::path& vertexShaderPath,
+        const std::filesystem::path& fragmentShaderPath,
+        size_t dataBufferIndex,
+        bool gpuCulled = false) override;
+
+    void createPipelines() override {}
+
+    std::vector<size_t> loadAtlas(const LoadedAtlas& atlas) override;
+
+    [[nodiscard]] uint32_t getFrameIndex(size_t textureIndex, size_t frame) override
+    {
+        return m_textureFirstFrames[textureIndex] + static_cast<uint32_t>(frame);
+    }
+
+    void updateTilemap(const Map& map) override;
+
+    [[nodiscard]] bool isGpuCullingActive() const override { return false; }
+
+    void drawScene(
+        const Camera& camera,
+        std::span<const DrawRequest> drawRequests,
+        ImDrawData* uiData) override;
+
+    [[nodiscard]] const NullRendererStatistics& getStatistics() const { return m_statistics; }
+
+    /**
+     * While enabled every draw of every frame is appended to the command stream, which grows without bound.
+     */
+    void setRecordingEnabled(bool enabled) { m_recordingEnabled = enabled; }
+    [[nodiscard]] const std::vector<RecordedDraw>& getCommandStream() const { return m_commandStream; }
+    void clearCommandStream() { m_commandStream.clear(); }
+
+    /**
+     * Sorted keys and batches of the last drawScene call, see DrawKey.
+     */
+    [[nodiscard]] const std::vector<uint64_t>& getLastDrawKeys() const { return m_drawKeys; }
+    [[nodiscard]] const std::vector<DrawBatch>& getLastDrawBatches() const { return m_drawBatches; }
+
+protected:
+    [[nodiscard]] std::weak_ptr<VulkanResources> getObjectBufferResources() const override { return {}; }
+    [[nodiscard]] size_t getObjectBufferFrames() const override { return 1; }
+
+private:
+    std::vector<size_t> m_pipelineDataBuffers{};
+    std::vector<uint32_t> m_textureFirstFrames{};
+    uint32_t m_frameCount = 0;
+    uint64_t m_mapRevision = 0;
+
+    std::vector<uint64_t> m_drawKeys{};
+    std::vector<uint64_t> m_drawKeysScratch{};
+    std::vector<DrawBatch> m_drawBatches{};
+
+    bool m_recordingEnabled = false;
+    std::vector<RecordedDraw> m_commandStream{};
+    NullRendererStatistics m_statistics{};
+};
+
+#endif //NULLRENDERER_H
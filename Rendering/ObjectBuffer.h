@@ -5,33 +5,35 @@
 #ifndef OBJECTBUFFER_H
 #define OBJECTBUFFER_H
 
+#include <algorithm>
+#include <cstring>
 #include <vector>
-#include "Buffer.h"
+#include "GrowableBuffer.h"
 #include "IGenericBuffer.h"
 
 template <typename T>
 class ObjectBuffer : public IGenericBuffer {
 
 public:
-    std::vector<std::unique_ptr<Buffer>> m_objectStagingBuffers{};
-    std::vector<std::unique_ptr<Buffer>> m_objectBuffers{};
+    std::vector<std::unique_ptr<GrowableBuffer>> m_objectBuffers{};
     std::vector<VkDescriptorSet> m_objectBufferDescriptors{};
     std::vector<T> m_data{};
     size_t m_dataSize = 0;
 
     ObjectBuffer(
         const std::weak_ptr<VulkanResources>& vulkanResources,
-        size_t images,
+        size_t frames,
         size_t bufferSize)
     {
         m_vulkanResources = vulkanResources;
-        m_images = images;
+        m_frames = frames;
         m_data.resize(bufferSize);
-        m_objectBufferDescriptors.reserve(images);
-        m_objectBuffers.reserve(images);
-        m_objectStagingBuffers.reserve(images);
+        m_objectBufferDescriptors.reserve(frames);
+        m_objectBuffers.reserve(frames);
+        m_dirtyPages.resize(frames);
 
         InitializeVulkanResources(bufferSize);
+        resizeDirtyPages();
     }
 
     ~ObjectBuffer() override
@@ -40,59 +42,155 @@ public:
         m_data.clear();
     }
 
-    void updateGpuBuffer(
+    void recordUpload(
         VkCommandBuffer commandBuffer,
-        VkQueue queue,
-        size_t imageIndex) const override
+        size_t frameIndex,
+        UploadRing& uploadRing,
+        std::vector<VkBufferMemoryBarrier>& barriers) override
     {
-        VkCommandBufferBeginInfo beginInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
-        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        // Growing copies the previous contents on the GPU, so only the dirty pages are uploaded afterwards as well
+        if (m_objectBuffers[frameIndex]->reserve(commandBuffer, sizeof(T) * m_dataSize))
+        {
+            writeDescriptor(frameIndex);
+        }
+
+        auto& dirtyPages = m_dirtyPages[frameIndex];
+        m_dirtyRanges.clear();
 
-        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+        // Consecutive dirty pages become one copy region
+        const size_t pageCount = getPageCount(m_dataSize);
+        size_t page = 0;
+
+        while (page < pageCount)
         {
-            throw std::runtime_error("failed to begin recording command buffer!");
+            if (!isPageDirty(dirtyPages, page))
+            {
+                page++;
+                continue;
+            }
+
+            const size_t firstPage = page;
+
+            while (page < pageCount && isPageDirty(dirtyPages, page))
+            {
+                page++;
+            }
+
+            const size_t first = firstPage * ELEMENTS_PER_PAGE;
+            const size_t last = std::min(page * ELEMENTS_PER_PAGE, m_dataSize);
+            m_dirtyRanges.push_back({ first, last - first });
         }
 
-        const auto& objectBuffer = m_objectBuffers[imageIndex];
-        const auto& stagingBuffer = *m_objectStagingBuffers[imageIndex];
-        const auto& data = m_data;
+        std::ranges::fill(dirtyPages, 0);
 
-        VkBufferCopy copyRegion{};
-        copyRegion.srcOffset = 0;
-        copyRegion.dstOffset = 0;
+        if (m_dirtyRanges.empty())
+        {
+            return;
+        }
 
-        if (m_dataSize == 0)
+        VkDeviceSize uploadSize = 0;
+
+        for (const auto& range : m_dirtyRanges)
         {
-            stagingBuffer.clear();
-            copyRegion.size = stagingBuffer.getSize();
+            uploadSize += sizeof(T) * range.count;
         }
-        else
+
+        // All regions of this buffer share one staging allocation and one copy command
+        const auto staging = uploadRing.allocate(uploadSize, UPLOAD_ALIGNMENT);
+        m_copyRegions.clear();
+
+        VkDeviceSize stagingOffset = 0;
+
+        for (const auto& range : m_dirtyRanges)
         {
-            const auto stagingBufferSize = sizeof(T) * m_dataSize;
-            stagingBuffer.writeData(data.data(), stagingBufferSize);
-            copyRegion.size = stagingBufferSize;
+            const VkDeviceSize size = sizeof(T) * range.count;
+            memcpy(static_cast<char*>(staging.data) + stagingOffset, &m_data[range.first], size);
+
+            VkBufferCopy copyRegion{};
+            copyRegion.srcOffset = staging.offset + stagingOffset;
+            copyRegion.dstOffset = sizeof(T) * range.first;
+            copyRegion.size = size;
+            m_copyRegions.push_back(copyRegion);
+
+            stagingOffset += size;
         }
 
-        vkCmdCopyBuffer(commandBuffer, stagingBuffer.getBuffer(), objectBuffer->getBuffer(), 1, &copyRegion);
-        vkEndCommandBuffer(commandBuffer);
+        uploadRing.flush(staging);
+
+        const auto& objectBuffer = *m_objectBuffers[frameIndex];
+
+        vkCmdCopyBuffer(
+            commandBuffer,
+            staging.buffer,
+            objectBuffer.getBuffer(),
+            static_cast<uint32_t>(m_copyRegions.size()),
+            m_copyRegions.data());
+
+        VkBufferMemoryBarrier barrier{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = objectBuffer.getBuffer();
+        barrier.offset = m_copyRegions.front().dstOffset;
+        barrier.size = m_copyRegions.back().dstOffset + m_copyRegions.back().size - barrier.offset;
+
+        barriers.push_back(barrier);
+    }
+
+    /**
+     * Writes value at index and marks it for upload. Values equal to the current ones are skipped,
+     * so objects that did not change since the last frame cost nothing to upload.
+     */
+    void set(size_t index, const T& value)
+    {
+        if (index >= m_data.size())
+        {
+            grow(index + 1);
+        }
 
-        VkSubmitInfo submitInfo{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &commandBuffer;
+        if (index < m_dataSize && memcmp(&m_data[index], &value, sizeof(T)) == 0)
+        {
+            return;
+        }
 
-        vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
+        m_data[index] = value;
+        m_dataSize = std::max(index + 1, m_dataSize);
+        markDirty(index, 1);
     }
 
     void append(T data)
     {
-        if (m_data.capacity() < m_dataSize + 1)
+        if (m_data.size() < m_dataSize + 1)
+        {
+            grow(m_dataSize + 1);
+        }
+
+        m_data[m_dataSize] = data;
+        markDirty(m_dataSize, 1);
+        m_dataSize++;
+    }
+
+    /**
+     * Marks count elements starting at first for upload to every frame, for callers that write m_data directly.
+     */
+    void markDirty(size_t first, size_t count)
+    {
+        if (count == 0)
         {
-            m_data.resize(m_data.capacity() * 2);
-            ClearVulkanResources();
-            InitializeVulkanResources(m_data.capacity());
+            return;
         }
 
-        m_data[m_dataSize++] = data;
+        const size_t firstPage = first / ELEMENTS_PER_PAGE;
+        const size_t lastPage = (first + count - 1) / ELEMENTS_PER_PAGE;
+
+        for (auto& dirtyPages : m_dirtyPages)
+        {
+            for (size_t page = firstPage; page <= lastPage; page++)
+            {
+                dirtyPages[page / 64] |= uint64_t{1} << (page % 64);
+            }
+        }
     }
 
     [[nodiscard]] size_t getCount() const override
@@ -110,14 +208,90 @@ public:
         return sizeof(T);
     }
 
-    [[nodiscard]] VkDescriptorSet getDescriptorSet(size_t imageIndex) const override
+    [[nodiscard]] VkDescriptorSet getDescriptorSet(size_t frameIndex) const override
     {
-        return m_objectBufferDescriptors[imageIndex];
+        return m_objectBufferDescriptors[frameIndex];
     }
 
 private:
+    typedef struct
+    {
+        size_t first;
+        size_t count;
+    } DirtyRange;
+
+    static constexpr VkDeviceSize UPLOAD_ALIGNMENT = 16;
+    static constexpr size_t DIRTY_PAGE_SIZE = 4096;
+    static constexpr size_t ELEMENTS_PER_PAGE = std::max<size_t>(1, DIRTY_PAGE_SIZE / sizeof(T));
+
     std::weak_ptr<VulkanResources> m_vulkanResources;
-    size_t m_images;
+    size_t m_frames;
+
+    // One bit per page of m_data and per frame in flight, every frame has its own GPU buffer that needs each change
+    std::vector<std::vector<uint64_t>> m_dirtyPages{};
+    std::vector<DirtyRange> m_dirtyRanges{};
+    std::vector<VkBufferCopy> m_copyRegions{};
+
+    [[nodiscard]] static size_t getPageCount(size_t elementCount)
+    {
+        return (elementCount + ELEMENTS_PER_PAGE - 1) / ELEMENTS_PER_PAGE;
+    }
+
+    [[nodiscard]] static bool isPageDirty(const std::vector<uint64_t>& dirtyPages, size_t page)
+    {
+        return dirtyPages[page / 64] & (uint64_t{1} << (page % 64));
+    }
+
+    void resizeDirtyPages()
+    {
+        const size_t wordCount = (getPageCount(m_data.size()) + 63) / 64;
+
+        for (auto& dirtyPages : m_dirtyPages)
+        {
+            dirtyPages.resize(wordCount, 0);
+        }
+    }
+
+    /**
+     * Only grows the CPU side data, the GPU buffers of every frame grow the next time they get uploaded to.
+     * Buffers and descriptor sets that frames in flight still use are never touched here.
+     */
+    void grow(size_t minimumSize)
+    {
+        m_data.resize(std::max(minimumSize, m_data.size() * 2));
+        resizeDirtyPages();
+    }
+
+    void writeDescriptor(size_t frameIndex)
+    {
+        if (m_vulkanResources.expired())
+        {
+            return;
+        }
+
+        const auto resources = m_vulkanResources.lock();
+
+        VkDescriptorBufferInfo bufferInfo{};
+        bufferInfo.buffer = m_objectBuffers[frameIndex]->getBuffer();
+        bufferInfo.offset = 0;
+        bufferInfo.range = m_objectBuffers[frameIndex]->getSize();
+
+        VkWriteDescriptorSet writeDescriptorSet{};
+        writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writeDescriptorSet.dstSet = m_objectBufferDescriptors[frameIndex];
+        writeDescriptorSet.dstBinding = 0;
+        writeDescriptorSet.dstArrayElement = 0;
+        writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writeDescriptorSet.descriptorCount = 1;
+        writeDescriptorSet.pBufferInfo = &bufferInfo;
+
+        vkUpdateDescriptorSets(
+            resources->m_logicalDevice,
+            1,
+            &writeDescriptorSet,
+            0,
+            nullptr);
+    }
 
     void InitializeVulkanResources(size_t bufferSize)
     {
@@ -129,11 +303,12 @@ private:
         const auto resources = m_vulkanResources.lock();
 
         const auto objectBufferLayout = resources->m_descriptorSetLayoutObjectsBuffer;
-        std::vector<VkDescriptorSetLayout> descriptorSetLayouts{m_images, objectBufferLayout};
+        std::vector<VkDescriptorSetLayout> descriptorSetLayouts{m_frames, objectBufferLayout};
+        m_objectBufferDescriptors.resize(m_frames);
 
         VkDescriptorSetAllocateInfo objectBufferInfo = {};
         objectBufferInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        objectBufferInfo.descriptorSetCount = m_images;
+        objectBufferInfo.descriptorSetCount = m_frames;
         objectBufferInfo.descriptorPool = resources->m_descriptorPool;
         objectBufferInfo.pSetLayouts = descriptorSetLayouts.data();
 
@@ -147,44 +322,16 @@ private:
             throw std::runtime_error("failed to allocate object buffer descriptor sets!");
         }
 
-        for (size_t i = 0; i < m_images; i++)
+        for (size_t i = 0; i < m_frames; i++)
         {
-            const auto size = sizeof(T) * bufferSize;
-
-            m_objectStagingBuffers.emplace_back(
-                std::make_unique<Buffer>(
-                    m_vulkanResources,
-                    size,
-                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
-
             m_objectBuffers.emplace_back(
-                std::make_unique<Buffer>(
+                std::make_unique<GrowableBuffer>(
                     m_vulkanResources,
-                    size,
-                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT));
-
-            VkDescriptorBufferInfo bufferInfo{};
-            bufferInfo.buffer = m_objectBuffers[i]->getBuffer();
-            bufferInfo.offset = 0;
-            bufferInfo.range = size;
+                    sizeof(T) * bufferSize,
+                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
 
-            VkWriteDescriptorSet writeDescriptorSet{};
-            writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            writeDescriptorSet.dstSet = m_objectBufferDescriptors[i];
-            writeDescriptorSet.dstBinding = 0;
-            writeDescriptorSet.dstArrayElement = 0;
-            writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-            writeDescriptorSet.descriptorCount = 1;
-            writeDescriptorSet.pBufferInfo = &bufferInfo;
-
-            vkUpdateDescriptorSets(
-                resources->m_logicalDevice,
-                1,
-                &writeDescriptorSet,
-                0,
-                nullptr);
+            writeDescriptor(i);
         }
     }
 
@@ -197,17 +344,13 @@ private:
 
         const auto resources = m_vulkanResources.lock();
 
-        if (!m_objectBufferDescriptors.empty())
+        for (const auto descriptorSet : m_objectBufferDescriptors)
         {
-            vkFreeDescriptorSets(
-                        resources->m_logicalDevice,
-                        resources->m_descriptorPool,
-                        m_objectBufferDescriptors.size(),
-                        m_objectBufferDescriptors.data());
-            m_objectBufferDescriptors.clear();
+            resources->m_deletionQueue->freeDescriptorSet(resources->m_descriptorPool, descriptorSet);
         }
 
-        m_objectStagingBuffers.clear();
+        m_objectBufferDescriptors.clear();
+
         m_objectBuffers.clear();
     }
 };
@@ -0,0 +1,155 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include "OffscreenTarget.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+OffscreenTarget::OffscreenTarget(
+    VkDevice device,
+    const VkAllocationCallbacks* allocator,
+    MemoryAllocator& memoryAllocator,
+    uint32_t width,
+    uint32_t height,
+    uint32_t imageCount)
+    : m_memoryAllocator(memoryAllocator)
+{
+    m_device = device;
+    m_allocator = allocator;
+    m_width = width;
+    m_height = height;
+
+    for (uint32_t i = 0; i < imageCount; i++)
+    {
+        m_images.push_back(createImage());
+    }
+}
+
+OffscreenTarget::~OffscreenTarget()
+{
+    for (const auto& target : m_images)
+    {
+        vkDestroyImageView(m_device, target.imageView, m_allocator);
+        vkDestroyImage(m_device, target.image, m_allocator);
+        m_memoryAllocator.free(target.imageAllocation);
+        vkDestroyBuffer(m_device, target.readbackBuffer, m_allocator);
+        m_memoryAllocator.free(target.readbackAllocation);
+    }
+}
+
+OffscreenTarget::TargetImage OffscreenTarget::createImage() const
+{
+    TargetImage target{};
+
+    VkImageCreateInfo imageInfo{ VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent.width = m_width;
+    imageInfo.extent.height = m_height;
+    imageInfo.extent.depth = 1;
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = FORMAT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+
+    if (vkCreateImage(m_device, &imageInfo, m_allocator, &target.image) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create offscreen image!");
+    }
+
+    target.imageAllocation = m_memoryAllocator.allocateForImage(target.image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    VkImageViewCreateInfo viewInfo{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+    viewInfo.image = target.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = FORMAT;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    if (vkCreateImageView(m_device, &viewInfo, m_allocator, &target.imageView) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create offscreen image view!");
+    }
+
+    VkBufferCreateInfo bufferInfo{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    bufferInfo.size = static_cast<VkDeviceSize>(m_width) * m_height * 4;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateBuffer(m_device, &bufferInfo, m_allocator, &target.readbackBuffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create readback buffer!");
+    }
+
+    // Coherent, so the CPU sees the copy without invalidating, cached to make reading it back fast
+    target.readbackAllocation = m_memoryAllocator.allocateForBuffer(
+        target.readbackBuffer,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+
+    return target;
+}
+
+void OffscreenTarget::recordReadback(VkCommandBuffer commandBuffer, size_t index) const
+{
+    const TargetImage& target = m_images[index];
+
+    VkBufferImageCopy region{};
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = { m_width, m_height, 1 };
+
+    vkCmdCopyImageToBuffer(
+        commandBuffer,
+        target.image,
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        target.readbackBuffer,
+        1,
+        &region);
+
+    VkBufferMemoryBarrier hostBarrier{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+    hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    hostBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    hostBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    hostBarrier.buffer = target.readbackBuffer;
+    hostBarrier.size = VK_WHOLE_SIZE;
+
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_HOST_BIT,
+        0,
+        0,
+        nullptr,
+        1,
+        &hostBarrier,
+        0,
+        nullptr);
+}
+
+ReadbackImage OffscreenTarget::readPixels(size_t index) const
+{
+    const auto* source = static_cast<const uint8_t*>(m_images[index].readbackAllocation.mappedData);
+
+    ReadbackImage image{};
+    image.width = m_width;
+    image.height = m_height;
+    image.pixels.resize(static_cast<size_t>(m_width) * m_height * 4);
+    memcpy(image.pixels.data(), source, image.pixels.size());
+
+    // The images are BGRA like the swapchain
+    for (size_t i = 0; i < image.pixels.size(); i += 4)
+    {
+        std::swap(image.pixels[i], image.pixels[i + 2]);
+    }
+
+    return image;
+}
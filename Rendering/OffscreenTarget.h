@@ -0,0 +1,81 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef OFFSCREENTARGET_H
+#define OFFSCREENTARGET_H
+
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "MemoryAllocator.h"
+
+typedef struct
+{
+    uint32_t width;
+    uint32_t height;
+    // Tightly packed RGBA8 rows, top row first
+    std::vector<uint8_t> pixels;
+} ReadbackImage;
+
+/**
+ * Color images the renderer draws into instead of swapchain images when there is no window, one per frame in flight
+ * so consecutive frames never write the same image. Each image has a host visible buffer of the same size that a
+ * frame can copy its image into for reading it back on the CPU.
+ */
+class OffscreenTarget
+{
+public:
+    static constexpr VkFormat FORMAT = VK_FORMAT_B8G8R8A8_UNORM;
+
+    OffscreenTarget(
+        VkDevice device,
+        const VkAllocationCallbacks* allocator,
+        MemoryAllocator& memoryAllocator,
+        uint32_t width,
+        uint32_t height,
+        uint32_t imageCount);
+
+    /**
+     * Expects the device to be idle.
+     */
+    ~OffscreenTarget();
+
+    [[nodiscard]] VkImage getImage(size_t index) const { return m_images[index].image; }
+    [[nodiscard]] VkImageView getImageView(size_t index) const { return m_images[index].imageView; }
+    [[nodiscard]] uint32_t getWidth() const { return m_width; }
+    [[nodiscard]] uint32_t getHeight() const { return m_height; }
+
+    /**
+     * Records the copy of image index into its readback buffer. The image has to be in TRANSFER_SRC_OPTIMAL layout.
+     */
+    void recordReadback(VkCommandBuffer commandBuffer, size_t index) const;
+
+    /**
+     * Converts the readback buffer of image index to RGBA. Only valid after the frame that recorded the readback
+     * finished on the GPU.
+     */
+    [[nodiscard]] ReadbackImage readPixels(size_t index) const;
+
+private:
+    typedef struct
+    {
+        VkImage image;
+        VkImageView imageView;
+        MemoryAllocation imageAllocation;
+        VkBuffer readbackBuffer;
+        MemoryAllocation readbackAllocation;
+    } TargetImage;
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    const VkAllocationCallbacks* m_allocator = nullptr;
+    MemoryAllocator& m_memoryAllocator;
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+    std::vector<TargetImage> m_images{};
+
+    TargetImage createImage() const;
+};
+
+#endif //OFFSCREENTARGET_H
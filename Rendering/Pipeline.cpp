@@ -16,17 +16,20 @@ Pipeline::~Pipeline()
 
     const auto& resources = m_vulkanResources.lock();
 
-    vkDestroyPipeline(resources->m_logicalDevice, m_pipeline, resources->m_allocator);
+    resources->m_deletionQueue->destroyPipeline(m_pipeline);
 }
 
 Pipeline::Pipeline(
     std::weak_ptr<VulkanResources> resources,
     const Shader& shader,
     VkFormat swapchainImageFormat,
-    size_t dataBufferIndex)
+    size_t dataBufferIndex,
+    bool gpuCulled,
+    VkPipelineLayout layout)
 {
     m_vulkanResources = resources;
     m_dataBufferIndex = dataBufferIndex;
+    m_gpuCulled = gpuCulled;
 
     if (resources.expired())
     {
@@ -98,7 +101,8 @@ Pipeline::Pipeline(
     colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
     colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
     colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
-    colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+    // Accumulates coverage in alpha, which offscreen targets like the chunk cache need to be composited again
+    colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
     colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
 
     VkPipelineColorBlendStateCreateInfo colorBlending{ VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO };
@@ -131,14 +135,14 @@ Pipeline::Pipeline(
     graphicsPipelineCreateInfo.pViewportState = &viewportState;
     graphicsPipelineCreateInfo.pColorBlendState = &colorBlending;
     graphicsPipelineCreateInfo.pDynamicState = &dynamicState;
-    graphicsPipelineCreateInfo.layout = lockedResources->m_pipelineLayout;
+    graphicsPipelineCreateInfo.layout = layout != VK_NULL_HANDLE ? layout : lockedResources->m_pipelineLayout;
     graphicsPipelineCreateInfo.renderPass = VK_NULL_HANDLE; // because we're using dynamic rendering
     graphicsPipelineCreateInfo.subpass = 0;
     graphicsPipelineCreateInfo.pMultisampleState = &multisampling;
 
     if (vkCreateGraphicsPipelines(
             lockedResources->m_logicalDevice,
-            nullptr,
+            lockedResources->m_pipelineCache->getCache(),
             1,
             &graphicsPipelineCreateInfo,
             lockedResources->m_allocator,
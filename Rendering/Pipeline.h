@@ -18,7 +18,9 @@ public:
         std::weak_ptr<VulkanResources> resources,
         const Shader& shader,
         VkFormat swapchainImageFormat,
-        size_t dataBufferIndex);
+        size_t dataBufferIndex,
+        bool gpuCulled = false,
+        VkPipelineLayout layout = VK_NULL_HANDLE);
 
     [[nodiscard]] VkPipeline getPipeline() const
     {
@@ -30,10 +32,19 @@ public:
         return m_dataBufferIndex;;
     }
 
+    /**
+     * Whether the data buffer of this pipeline holds sprites the culling pass can test against the camera.
+     */
+    [[nodiscard]] bool isGpuCulled() const
+    {
+        return m_gpuCulled;
+    }
+
 private:
     std::weak_ptr<VulkanResources> m_vulkanResources;
     VkPipeline m_pipeline;
     size_t m_dataBufferIndex;
+    bool m_gpuCulled = false;
 };
 
 #endif //PIPELINE_H
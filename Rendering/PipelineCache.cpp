@@ -0,0 +1,148 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include "PipelineCache.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include "Logger.h"
+
+namespace
+{
+    std::vector<char> readCacheFile(const std::filesystem::path& filePath)
+    {
+        std::ifstream file(filePath, std::ios::ate | std::ios::binary);
+
+        if (!file.is_open())
+        {
+            return {};
+        }
+
+        std::vector<char> data(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(data.data(), static_cast<std::streamsize>(data.size()));
+
+        return file ? data : std::vector<char>{};
+    }
+
+    bool matchesDevice(const std::vector<char>& data, const VkPhysicalDeviceProperties& deviceProperties)
+    {
+        VkPipelineCacheHeaderVersionOne header{};
+
+        if (data.size() < sizeof(header))
+        {
+            return false;
+        }
+
+        memcpy(&header, data.data(), sizeof(header));
+
+        return header.headerSize >= sizeof(header) &&
+               header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+               header.vendorID == deviceProperties.vendorID &&
+               header.deviceID == deviceProperties.deviceID &&
+               memcmp(header.pipelineCacheUUID, deviceProperties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+    }
+}
+
+PipelineCache::PipelineCache(
+    const VkPhysicalDeviceProperties& deviceProperties,
+    VkDevice device,
+    const VkAllocationCallbacks* allocator,
+    std::filesystem::path filePath)
+{
+    m_device = device;
+    m_allocator = allocator;
+    m_filePath = std::move(filePath);
+
+    std::vector<char> data = readCacheFile(m_filePath);
+
+    if (!data.empty() && !matchesDevice(data, deviceProperties))
+    {
+        Logger::log(
+            LogLevel::Warning,
+            "PipelineCache",
+            "{} belongs to another device or driver, starting cold",
+            m_filePath);
+        data.clear();
+
+        // Removed right away instead of waiting for the save at shutdown, which a crash would skip
+        std::error_code error;
+        std::filesystem::remove(m_filePath, error);
+
+        if (error)
+        {
+            Logger::log(LogLevel::Warning, "PipelineCache", "Failed to remove {}: {}", m_filePath, error.message());
+        }
+    }
+
+    VkPipelineCacheCreateInfo createInfo{ VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
+    createInfo.initialDataSize = data.size();
+    createInfo.pInitialData = data.empty() ? nullptr : data.data();
+
+    if (vkCreatePipelineCache(m_device, &createInfo, m_allocator, &m_cache) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create pipeline cache");
+    }
+
+    m_loadedBytes = data.size();
+}
+
+PipelineCache::~PipelineCache()
+{
+    try
+    {
+        save();
+    }
+    catch (const std::exception& exception)
+    {
+        Logger::log(LogLevel::Error, "PipelineCache", "Failed to save: {}", std::string_view(exception.what()));
+    }
+
+    vkDestroyPipelineCache(m_device, m_cache, m_allocator);
+}
+
+void PipelineCache::save() const
+{
+    size_t size = 0;
+
+    if (vkGetPipelineCacheData(m_device, m_cache, &size, nullptr) != VK_SUCCESS || size == 0)
+    {
+        return;
+    }
+
+    std::vector<char> data(size);
+
+    if (vkGetPipelineCacheData(m_device, m_cache, &size, data.data()) != VK_SUCCESS)
+    {
+        return;
+    }
+
+    // Written next to the old file and swapped in, so a crash while saving never leaves a truncated cache behind
+    std::filesystem::path temporaryPath = m_filePath;
+    temporaryPath += ".tmp";
+
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+
+        if (!file.is_open())
+        {
+            Logger::log(LogLevel::Warning, "PipelineCache", "Could not open {} for writing", temporaryPath);
+            return;
+        }
+
+        file.write(data.data(), static_cast<std::streamsize>(size));
+
+        if (!file)
+        {
+            throw std::runtime_error("failed to write pipeline cache");
+        }
+    }
+
+    std::filesystem::rename(temporaryPath, m_filePath);
+
+    Logger::log(LogLevel::Info, "PipelineCache", "Saved {} KiB to {}", size / 1024, m_filePath);
+}
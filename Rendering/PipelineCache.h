@@ -0,0 +1,49 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef PIPELINECACHE_H
+#define PIPELINECACHE_H
+
+#include <filesystem>
+#include <vulkan/vulkan.h>
+
+/**
+ * VkPipelineCache that is loaded from and saved to a file, so pipelines compiled by one run are reused by the next.
+ * The file is only used when its header matches the vendor, device and pipeline cache UUID of the current device,
+ * a driver update or another GPU starts with an empty cache instead. Pipelines can be created with the cache from
+ * several threads at once.
+ */
+class PipelineCache
+{
+public:
+    PipelineCache(
+        const VkPhysicalDeviceProperties& deviceProperties,
+        VkDevice device,
+        const VkAllocationCallbacks* allocator,
+        std::filesystem::path filePath);
+
+    /**
+     * Writes the cache back to its file.
+     */
+    ~PipelineCache();
+
+    [[nodiscard]] VkPipelineCache getCache() const { return m_cache; }
+
+    /**
+     * Whether the cache started from a valid file, pipeline creation is expected to be fast then.
+     */
+    [[nodiscard]] bool isWarm() const { return m_loadedBytes > 0; }
+    [[nodiscard]] size_t getLoadedBytes() const { return m_loadedBytes; }
+
+private:
+    VkDevice m_device = VK_NULL_HANDLE;
+    const VkAllocationCallbacks* m_allocator = nullptr;
+    VkPipelineCache m_cache = VK_NULL_HANDLE;
+    std::filesystem::path m_filePath;
+    size_t m_loadedBytes = 0;
+
+    void save() const;
+};
+
+#endif //PIPELINECACHE_H
@@ -0,0 +1,150 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include "PngWriter.h"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    // Largest payload of a stored deflate block
+    constexpr size_t MAX_STORED_BLOCK = 65535;
+
+    uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0)
+    {
+        static const std::array<uint32_t, 256> table = []
+        {
+            std::array<uint32_t, 256> entries{};
+
+            for (uint32_t i = 0; i < 256; i++)
+            {
+                uint32_t value = i;
+
+                for (int bit = 0; bit < 8; bit++)
+                {
+                    value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+                }
+
+                entries[i] = value;
+            }
+
+            return entries;
+        }();
+
+        crc = ~crc;
+
+        for (size_t i = 0; i < size; i++)
+        {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+
+        return ~crc;
+    }
+
+    void appendBigEndian(std::vector<uint8_t>& out, uint32_t value)
+    {
+        out.push_back(static_cast<uint8_t>(value >> 24));
+        out.push_back(static_cast<uint8_t>(value >> 16));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    void writeChunk(std::ofstream& file, const char* type, const std::vector<uint8_t>& data)
+    {
+        std::vector<uint8_t> chunk{};
+        chunk.reserve(data.size() + 12);
+        appendBigEndian(chunk, static_cast<uint32_t>(data.size()));
+        chunk.insert(chunk.end(), type, type + 4);
+        chunk.insert(chunk.end(), data.begin(), data.end());
+
+        // The CRC covers the type and the data, not the length
+        appendBigEndian(chunk, crc32(chunk.data() + 4, chunk.size() - 4));
+
+        file.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+    }
+}
+
+void PngWriter::write(const std::filesystem::path& filePath, const ReadbackImage& image)
+{
+    const size_t rowBytes = static_cast<size_t>(image.width) * 4;
+
+    if (image.pixels.size() != rowBytes * image.height)
+    {
+        throw std::runtime_error("PNG image data does not match its size");
+    }
+
+    // Every row starts with filter type 0, no filtering
+    std::vector<uint8_t> raw{};
+    raw.reserve((rowBytes + 1) * image.height);
+
+    for (uint32_t y = 0; y < image.height; y++)
+    {
+        raw.push_back(0);
+        raw.insert(raw.end(), image.pixels.begin() + y * rowBytes, image.pixels.begin() + (y + 1) * rowBytes);
+    }
+
+    std::vector<uint8_t> zlib{ 0x78, 0x01 };
+    zlib.reserve(raw.size() + raw.size() / MAX_STORED_BLOCK * 5 + 16);
+
+    uint32_t adlerA = 1;
+    uint32_t adlerB = 0;
+
+    for (size_t offset = 0; offset < raw.size() || offset == 0; offset += MAX_STORED_BLOCK)
+    {
+        const size_t size = std::min(MAX_STORED_BLOCK, raw.size() - offset);
+        const bool last = offset + size >= raw.size();
+
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back(static_cast<uint8_t>(size));
+        zlib.push_back(static_cast<uint8_t>(size >> 8));
+        zlib.push_back(static_cast<uint8_t>(~size));
+        zlib.push_back(static_cast<uint8_t>(~size >> 8));
+        zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + size);
+
+        for (size_t i = offset; i < offset + size; i++)
+        {
+            adlerA = (adlerA + raw[i]) % 65521;
+            adlerB = (adlerB + adlerA) % 65521;
+        }
+
+        if (last)
+        {
+            break;
+        }
+    }
+
+    appendBigEndian(zlib, (adlerB << 16) | adlerA);
+
+    std::vector<uint8_t> header{};
+    appendBigEndian(header, image.width);
+    appendBigEndian(header, image.height);
+    header.push_back(8); // bit depth
+    header.push_back(6); // RGBA
+    header.push_back(0); // deflate
+    header.push_back(0); // adaptive filtering
+    header.push_back(0); // no interlace
+
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open())
+    {
+        throw std::runtime_error("failed to open " + filePath.string() + " for writing");
+    }
+
+    static constexpr uint8_t SIGNATURE[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    file.write(reinterpret_cast<const char*>(SIGNATURE), sizeof(SIGNATURE));
+
+    writeChunk(file, "IHDR", header);
+    writeChunk(file, "IDAT", zlib);
+    writeChunk(file, "IEND", {});
+
+    if (!file)
+    {
+        throw std::runtime_error("failed to write " + filePath.string());
+    }
+}
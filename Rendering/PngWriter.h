@@ -0,0 +1,22 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef PNGWRITER_H
+#define PNGWRITER_H
+
+#include <filesystem>
+
+#include "OffscreenTarget.h"
+
+/**
+ * Writes RGBA8 images as PNG files. The image data is stored uncompressed inside the zlib stream, which keeps the
+ * writer small and dependency free. Meant for golden images of headless runs, not for shipping assets.
+ */
+class PngWriter
+{
+public:
+    static void write(const std::filesystem::path& filePath, const ReadbackImage& image);
+};
+
+#endif //PNGWRITER_H
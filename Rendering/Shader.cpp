@@ -6,6 +6,10 @@
 #include <vector>
 #include <fstream>
 
+#ifndef SHADER_BINARY_DIRECTORY
+#error "SHADER_BINARY_DIRECTORY must name the directory the shaders are compiled into"
+#endif
+
 static std::vector<char> readFile(const std::filesystem::path& fileName) {
     std::ifstream file(fileName, std::ios::ate | std::ios::binary);
 
@@ -66,3 +70,12 @@ VkShaderModule Shader::getVertexShaderModule() const
     return m_vertexShaderModule;
 }
 
+VkShaderModule Shader::loadModule(VkDevice device, const std::filesystem::path& filePath)
+{
+    return createShaderModule(device, filePath);
+}
+
+std::filesystem::path Shader::getBinaryDirectory()
+{
+    return SHADER_BINARY_DIRECTORY;
+}
@@ -20,6 +20,13 @@ public:
     [[nodiscard]] VkShaderModule getFragmentShaderModule() const;
     [[nodiscard]] VkShaderModule getVertexShaderModule() const;
 
+    static VkShaderModule loadModule(VkDevice device, const std::filesystem::path& filePath);
+
+    /**
+     * The directory the build compiles the shaders into, with the same layout as Assets/Shaders.
+     */
+    static std::filesystem::path getBinaryDirectory();
+
 private:
     VkDevice m_device;
     VkShaderModule m_fragmentShaderModule;
@@ -9,11 +9,20 @@
 
 #include "ImageRect.h"
 
+// The vertex shader rebuilds the transform from position and size, the UV rect and texture come from the frame table
 struct SpriteRenderData {
-    glm::mat4 modelMatrix;  // 64 bytes  64
-    ImageRect spriteFrame;  // 16 bytes  80
-    uint32_t textureIndex;  //  4 bytes  84
-    uint32_t _pad[3];       // 12 bytes  96
+    glm::vec2 position;     //  8 bytes   8
+    uint32_t size;          //  4 bytes  12  width and height as packed half floats, negative values flip
+    uint32_t frameIndex;    //  4 bytes  16  index into the frame table
 };
 
+// One entry per frame of every loaded texture, uploaded once when a texture is loaded. Laid out like the std430
+// array of the shaders, which has a stride of 20 bytes since neither member needs more than 4 byte alignment
+struct FrameTableEntry {
+    ImageRect rect;         // 16 bytes  16
+    uint32_t textureIndex;  //  4 bytes  20
+};
+
+static_assert(sizeof(FrameTableEntry) == 20, "FrameTableEntry has to match the std430 stride of the shaders");
+
 #endif //UNIFORMBUFFEROBJECT_H
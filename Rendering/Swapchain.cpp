@@ -66,13 +66,11 @@ Swapchain::Swapchain(
     VkPhysicalDevice physicalDevice,
     VkDevice logicalDevice,
     VkSurfaceKHR surface,
-    VkCommandPool commandPool,
     VkAllocationCallbacks* allocator,
     uint32_t windowWidth,
     uint32_t windowHeight)
 {
     m_allocator = allocator;
-    m_commandPool = commandPool;
     m_logicalDevice = logicalDevice;
 
     VkSurfaceCapabilitiesKHR capabilities;
@@ -94,7 +92,14 @@ Swapchain::Swapchain(
     VkSwapchainCreateInfoKHR createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
     createInfo.surface = surface;
-    createInfo.minImageCount = capabilities.minImageCount;
+    // One image more than the minimum, so acquiring does not wait for the presentation engine while frames are in flight
+    createInfo.minImageCount = capabilities.minImageCount + 1;
+
+    if (capabilities.maxImageCount > 0)
+    {
+        createInfo.minImageCount = std::min(createInfo.minImageCount, capabilities.maxImageCount);
+    }
+
     createInfo.imageFormat = m_format.format;
     createInfo.imageColorSpace = m_format.colorSpace;
     createInfo.imageExtent = { m_width, m_height };
@@ -127,17 +132,6 @@ Swapchain::Swapchain(
     }
 
     m_swapChainElements.resize(imageCount);
-    std::vector<VkCommandBuffer> commandBuffers(imageCount);
-
-    VkCommandBufferAllocateInfo allocInfo{};
-    allocInfo.commandBufferCount = imageCount;
-    allocInfo.commandPool = commandPool;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-
-    if (vkAllocateCommandBuffers(logicalDevice, &allocInfo, commandBuffers.data()) != VK_SUCCESS) {
-        throw std::runtime_error("failed to allocate command buffers!");
-    }
 
     for (size_t i = 0; i < imageCount; i++)
     {
@@ -148,38 +142,19 @@ Swapchain::Swapchain(
             VK_IMAGE_ASPECT_COLOR_BIT,
             allocator);
 
-        VkSemaphore startSemaphore = VK_NULL_HANDLE;
         VkSemaphore endSemaphore = VK_NULL_HANDLE;
         VkSemaphoreCreateInfo semaphoreCreateInfo{};
         semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-        if (vkCreateSemaphore(logicalDevice, &semaphoreCreateInfo, allocator, &startSemaphore) != VK_SUCCESS)
-        {
-            throw std::runtime_error("failed to create start semaphore!");
-        }
-
         if (vkCreateSemaphore(logicalDevice, &semaphoreCreateInfo, allocator, &endSemaphore) != VK_SUCCESS)
         {
             throw std::runtime_error("failed to create end semaphore!");
         }
 
-        VkFence fence = VK_NULL_HANDLE;
-        VkFenceCreateInfo fenceCreateInfo{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
-        fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-        if (vkCreateFence(logicalDevice, &fenceCreateInfo, allocator, &fence) != VK_SUCCESS)
-        {
-            throw std::runtime_error("failed to create fence!");
-        }
-
         SwapchainElement element
         {
             images[i],
             imageView,
-            commandBuffers[i],
-            fence,
-            VK_NULL_HANDLE,
-            startSemaphore,
             endSemaphore
         };
 
@@ -193,26 +168,13 @@ Swapchain::~Swapchain()
     {
         vkDestroyImageView(m_logicalDevice, element.imageView, m_allocator);
         vkDestroySemaphore(m_logicalDevice, element.endSemaphore, m_allocator);
-        vkDestroySemaphore(m_logicalDevice, element.startSemaphore, m_allocator);
-        vkDestroyFence(m_logicalDevice, element.fence, m_allocator);
-        vkFreeCommandBuffers(m_logicalDevice, m_commandPool, 1, &element.commandBuffer);
     }
 
     vkDestroySwapchainKHR(m_logicalDevice, m_swapchain, m_allocator);
 }
 
-SwapchainElement* Swapchain::getCurrentFrame()
-{
-    return &m_swapChainElements[m_currentFrame];
-}
-
 SwapchainElement* Swapchain::getFrameAt(size_t index)
 {
     return &m_swapChainElements[index];
 }
 
-void Swapchain::moveToNextFrame()
-{
-    m_currentFrame = (m_currentFrame + 1) % m_swapChainElements.size();
-}
-
@@ -24,32 +24,22 @@ public:
     VkPhysicalDevice physicalDevice,
     VkDevice logicalDevice,
     VkSurfaceKHR surface,
-    VkCommandPool commandPool,
     VkAllocationCallbacks* allocator,
     uint32_t windowWidth,
     uint32_t windowHeight);
     ~Swapchain();
 
-    SwapchainElement* getCurrentFrame();
     SwapchainElement* getFrameAt(size_t index);
-    void moveToNextFrame();
 
     [[nodiscard]] size_t getImageCount() const
     {
         return m_swapChainElements.size();
     }
 
-    [[nodiscard]] size_t getCurrentFrameIndex() const
-    {
-        return m_currentFrame;;
-    }
-
 private:
     VkDevice m_logicalDevice = VK_NULL_HANDLE;
-    VkCommandPool m_commandPool = VK_NULL_HANDLE;
     VkAllocationCallbacks* m_allocator = nullptr;
     std::vector<SwapchainElement> m_swapChainElements;
-    size_t m_currentFrame = 0;
 };
 
 #endif //SWAPCHAIN_H
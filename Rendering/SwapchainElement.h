@@ -11,10 +11,7 @@ struct SwapchainElement
 {
     VkImage image = VK_NULL_HANDLE;
     VkImageView imageView = VK_NULL_HANDLE;
-    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
-    VkFence fence = VK_NULL_HANDLE;
-    VkFence lastFence = VK_NULL_HANDLE;
-    VkSemaphore startSemaphore = VK_NULL_HANDLE;
+    // Per image rather than per frame in flight, the present may still wait on it when the next frame is submitted
     VkSemaphore endSemaphore = VK_NULL_HANDLE;
 };
 
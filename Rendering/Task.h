@@ -0,0 +1,158 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef TASK_H
+#define TASK_H
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+template<typename T>
+class Task;
+
+namespace TaskDetail
+{
+    /**
+     * Resumes whoever awaited the task once it finished, without growing the stack of the thread that ran it.
+     */
+    struct FinalAwaiter
+    {
+        bool await_ready() const noexcept { return false; }
+
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept
+        {
+            if (handle.promise().continuation)
+            {
+                return handle.promise().continuation;
+            }
+
+            return std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    struct PromiseBase
+    {
+        std::coroutine_handle<> continuation{};
+        std::exception_ptr exception{};
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+        void unhandled_exception() { exception = std::current_exception(); }
+    };
+
+    template<typename T>
+    struct Promise : PromiseBase
+    {
+        std::optional<T> value{};
+
+        Task<T> get_return_object();
+        void return_value(T result) { value.emplace(std::move(result)); }
+
+        T takeResult()
+        {
+            if (exception)
+            {
+                std::rethrow_exception(exception);
+            }
+
+            return std::move(*value);
+        }
+    };
+
+    template<>
+    struct Promise<void> : PromiseBase
+    {
+        Task<void> get_return_object();
+        void return_void() const noexcept {}
+
+        void takeResult() const
+        {
+            if (exception)
+            {
+                std::rethrow_exception(exception);
+            }
+        }
+    };
+}
+
+/**
+ * Lazily started coroutine that produces a T. It only runs once it is awaited, on the thread that awaits it, and
+ * resumes the awaiting coroutine when it finished. Exceptions are rethrown to the awaiting coroutine.
+ * Switching threads is up to the coroutine itself, by awaiting ThreadPool::schedule.
+ */
+template<typename T>
+class Task
+{
+public:
+    using promise_type = TaskDetail::Promise<T>;
+
+    explicit Task(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+    Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, {})) {}
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task()
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+        }
+    }
+
+    auto operator co_await() && noexcept
+    {
+        struct Awaiter
+        {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept { return false; }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) const noexcept
+            {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+
+            T await_resume() const { return handle.promise().takeResult(); }
+        };
+
+        return Awaiter{ m_handle };
+    }
+
+private:
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+template<typename T>
+Task<T> TaskDetail::Promise<T>::get_return_object()
+{
+    return Task<T>(std::coroutine_handle<Promise>::from_promise(*this));
+}
+
+inline Task<void> TaskDetail::Promise<void>::get_return_object()
+{
+    return Task<void>(std::coroutine_handle<Promise>::from_promise(*this));
+}
+
+/**
+ * Coroutine that starts right away and destroys itself when it finished. Used to run a Task without awaiting it.
+ */
+struct DetachedTask
+{
+    struct promise_type
+    {
+        DetachedTask get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+#endif //TASK_H
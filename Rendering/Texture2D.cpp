@@ -4,12 +4,14 @@
 
 #include "Texture2D.h"
 
+#include <algorithm>
 #include <memory>
 #include <stdexcept>
 
-#include "Buffer.h"
+
+// The stb_image implementation lives in this translation unit only
+#define STB_IMAGE_IMPLEMENTATION
 #include "ImageLoader.h"
-#include "VulkanHelpers.h"
 #include "VulkanResources.h"
 
 Texture2D::~Texture2D()
@@ -21,60 +23,84 @@ Texture2D::~Texture2D()
 
     const auto resources = m_vulkanResources.lock();
 
-    vkDestroyImageView(resources->m_logicalDevice, m_textureImageView, resources->m_allocator);
-    vkDestroyImage(resources->m_logicalDevice, m_textureImage, resources->m_allocator);
-    vkFreeMemory(resources->m_logicalDevice, m_textureImageMemory, resources->m_allocator);
+    resources->m_deletionQueue->destroyImageView(m_textureImageView);
+    resources->m_deletionQueue->destroyImage(m_textureImage, m_textureImageAllocation);
 }
 
 Texture2D::Texture2D(
     std::weak_ptr<VulkanResources> vulkanResources,
     const std::filesystem::path& assetsBasePath,
-    const AtlasEntry& spriteInfo)
+    const AtlasEntry& spriteInfo,
+    TextureUploadBatch* uploadBatch)
 {
     m_vulkanResources = std::move(vulkanResources);
 
     const ImageInfo imageInfo = ImageLoader::loadImage(assetsBasePath / spriteInfo.filePath);
-    const VkDeviceSize imageSize = imageInfo.width * imageInfo.height * 4;
 
+    upload(
+        static_cast<uint32_t>(imageInfo.width),
+        static_cast<uint32_t>(imageInfo.height),
+        imageInfo.data,
+        uploadBatch);
+    stbi_image_free(imageInfo.data);
+
+    m_frames.resize(std::max<size_t>(spriteInfo.frames.size(), 1));
+
+    for (size_t i = 0; i < spriteInfo.frames.size(); i++)
+    {
+        const auto& frame = spriteInfo.frames[i];
+
+        m_frames[i] =
+        {
+            .translateX = static_cast<float>(frame.x) / static_cast<float>(m_textureWidth),
+            .translateY = static_cast<float>(frame.y) / static_cast<float>(m_textureHeight),
+            .scaleX = static_cast<float>(frame.width) / static_cast<float>(m_textureWidth),
+            .scaleY = static_cast<float>(frame.height) / static_cast<float>(m_textureHeight)
+        };
+    }
+}
+
+Texture2D::Texture2D(
+    std::weak_ptr<VulkanResources> vulkanResources,
+    uint32_t width,
+    uint32_t height,
+    const void* pixels,
+    TextureUploadBatch* uploadBatch)
+{
+    m_vulkanResources = std::move(vulkanResources);
+
+    upload(width, height, pixels, uploadBatch);
+
+    m_frames.resize(1);
+    m_frames[0] = { .translateX = 0.0f, .translateY = 0.0f, .scaleX = 1.0f, .scaleY = 1.0f };
+}
+
+void Texture2D::upload(uint32_t width, uint32_t height, const void* pixels, TextureUploadBatch* uploadBatch)
+{
     createImage(
-        imageInfo.width,
-        imageInfo.height,
+        width,
+        height,
         VK_FORMAT_R8G8B8A8_SRGB,
         VK_IMAGE_TILING_OPTIMAL,
         VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
         m_textureImage,
-        m_textureImageMemory);
-
-    m_textureHeight = static_cast<uint32_t>(imageInfo.height);
-    m_textureWidth = static_cast<uint32_t>(imageInfo.width);
-
-    Buffer stagingBuffer(
-        m_vulkanResources,
-        imageSize,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-    stagingBuffer.writeData(imageInfo.data, imageSize);
-    stbi_image_free(imageInfo.data);
+        m_textureImageAllocation);
 
-    transitionImageLayout(
-        m_textureImage,
-        VK_FORMAT_R8G8B8A8_SRGB,
-        VK_IMAGE_LAYOUT_UNDEFINED,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    m_textureHeight = height;
+    m_textureWidth = width;
 
-    copyBufferToImage(
-        stagingBuffer,
-        m_textureImage,
-        static_cast<uint32_t>(imageInfo.width),
-        static_cast<uint32_t>(imageInfo.height));
-
-    transitionImageLayout(
-        m_textureImage,
-        VK_FORMAT_R8G8B8A8_SRGB,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    // A texture without a batch still uploads in a single submission, through a batch of its own
+    if (uploadBatch)
+    {
+        uploadBatch->add(m_textureImage, width, height, pixels);
+    }
+    else
+    {
+        TextureUploadBatch batch(m_vulkanResources);
+        batch.add(m_textureImage, width, height, pixels);
+        batch.submit();
+    }
 
     VkImageViewCreateInfo viewInfo{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
     viewInfo.image = m_textureImage;
@@ -86,21 +112,6 @@ Texture2D::Texture2D(
     viewInfo.subresourceRange.baseArrayLayer = 0;
     viewInfo.subresourceRange.layerCount = 1;
 
-    m_frames.reserve(spriteInfo.frames.size());
-
-    for (size_t i = 0; i < spriteInfo.frames.size(); i++)
-    {
-        const auto& frame = spriteInfo.frames[i];
-
-        m_frames[i] =
-        {
-            .translateX = static_cast<float>(frame.x) / static_cast<float>(m_textureWidth),
-            .translateY = static_cast<float>(frame.y) / static_cast<float>(m_textureHeight),
-            .scaleX = static_cast<float>(frame.width) / static_cast<float>(m_textureWidth),
-            .scaleY = static_cast<float>(frame.height) / static_cast<float>(m_textureHeight)
-        };
-    }
-
     if (m_vulkanResources.expired())
     {
         return;
@@ -121,7 +132,7 @@ void Texture2D::createImage(
     VkImageUsageFlags usage,
     VkMemoryPropertyFlags properties,
     VkImage &image,
-    VkDeviceMemory &imageMemory)
+    MemoryAllocation &imageAllocation)
 {
     if (m_vulkanResources.expired())
     {
@@ -149,174 +160,5 @@ void Texture2D::createImage(
         throw std::runtime_error("Failed to create image!");
     }
 
-    VkMemoryRequirements memRequirements;
-    vkGetImageMemoryRequirements(resources->m_logicalDevice, image, &memRequirements);
-
-    VkMemoryAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = VulkanHelpers::findMemoryType(
-        resources->m_physicalDevice,
-        memRequirements.memoryTypeBits,
-        properties
-    );
-
-    if (vkAllocateMemory(resources->m_logicalDevice, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to allocate image memory!");
-    }
-
-    vkBindImageMemory(resources->m_logicalDevice, image, imageMemory, 0);
-}
-
-void Texture2D::transitionImageLayout(
-    VkImage image,
-    VkFormat format,
-    VkImageLayout oldLayout,
-    VkImageLayout newLayout)
-{
-    if (m_vulkanResources.expired())
-    {
-        return;
-    }
-
-    const auto resources = m_vulkanResources.lock();
-
-    VkCommandPool commandPool = resources->m_commandPool;
-    VkQueue graphicsQueue = resources->m_graphicsQueue;
-    VkDevice device = resources->m_logicalDevice;
-
-    VkCommandBufferAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
-    allocInfo.commandPool = commandPool;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandBufferCount = 1;
-
-    VkCommandBuffer commandBuffer;
-    vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer);
-
-    VkCommandBufferBeginInfo beginInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-    vkBeginCommandBuffer(commandBuffer, &beginInfo);
-
-    VkImageMemoryBarrier barrier{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
-    barrier.oldLayout = oldLayout;
-    barrier.newLayout = newLayout;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.image = image;
-
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-
-    VkPipelineStageFlags sourceStage;
-    VkPipelineStageFlags destinationStage;
-
-    if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED &&
-        newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
-    {
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-        sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-    }
-    else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL &&
-             newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
-    {
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-        sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-        destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-    }
-
-    vkCmdPipelineBarrier(
-        commandBuffer,
-        sourceStage,
-        destinationStage,
-        0,
-        0,
-        nullptr,
-        0,
-        nullptr,
-        1,
-        &barrier
-    );
-
-    vkEndCommandBuffer(commandBuffer);
-
-    VkSubmitInfo submitInfo{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer;
-
-    vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(graphicsQueue);
-
-    vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
+    imageAllocation = resources->m_memoryAllocator->allocateForImage(image, properties);
 }
-
-void Texture2D::copyBufferToImage(
-    Buffer& buffer,
-    VkImage image,
-    uint32_t width,
-    uint32_t height)
-{
-    if (m_vulkanResources.expired())
-    {
-        return;
-    }
-
-    const auto resources = m_vulkanResources.lock();
-
-    VkCommandPool commandPool = resources->m_commandPool;
-    VkQueue graphicsQueue = resources->m_graphicsQueue;
-    VkDevice device = resources->m_logicalDevice;
-
-    VkCommandBufferAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
-    allocInfo.commandPool = commandPool;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandBufferCount = 1;
-
-    VkCommandBuffer commandBuffer;
-    vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer);
-
-    VkCommandBufferBeginInfo beginInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-    vkBeginCommandBuffer(commandBuffer, &beginInfo);
-
-    VkBufferImageCopy region{};
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;     // tightly packed
-    region.bufferImageHeight = 0;
-
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = 1;
-
-    region.imageOffset = {0, 0, 0};
-    region.imageExtent = {width, height, 1};
-
-    vkCmdCopyBufferToImage(
-        commandBuffer,
-        buffer.getBuffer(),
-        image,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        1,
-        &region
-    );
-
-    vkEndCommandBuffer(commandBuffer);
-
-    VkSubmitInfo submitInfo{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer;
-
-    vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(graphicsQueue);
-
-    vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
-}
-
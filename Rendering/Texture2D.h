@@ -14,6 +14,7 @@
 #include <filesystem>
 
 #include "ImageRect.h"
+#include "TextureUploadBatch.h"
 
 class Texture2D
 {
@@ -21,7 +22,19 @@ public:
     Texture2D(
         std::weak_ptr<VulkanResources> vulkanResources,
         const std::filesystem::path& assetsBasePath,
-        const AtlasEntry& spriteInfo);
+        const AtlasEntry& spriteInfo,
+        TextureUploadBatch* uploadBatch = nullptr);
+
+    /**
+     * Creates the texture from tightly packed RGBA pixels, with a single frame covering all of it.
+     * With an uploadBatch the pixels are only staged, the texture must not be used before the batch was submitted.
+     */
+    Texture2D(
+        std::weak_ptr<VulkanResources> vulkanResources,
+        uint32_t width,
+        uint32_t height,
+        const void* pixels,
+        TextureUploadBatch* uploadBatch = nullptr);
     ~Texture2D();
 
     [[nodiscard]] VkImageView getImageView() const
@@ -32,16 +45,19 @@ public:
     [[nodiscard]] uint32_t getWidth() const { return m_textureWidth;}
     [[nodiscard]] uint32_t getHeight() const { return m_textureHeight;}
     [[nodiscard]] const ImageRect& getFrame(size_t index) const { return m_frames[index];}
+    [[nodiscard]] size_t getFrameCount() const { return m_frames.size(); }
 
 private:
     std::weak_ptr<VulkanResources> m_vulkanResources;
     VkImage m_textureImage = VK_NULL_HANDLE;
     VkImageView m_textureImageView = VK_NULL_HANDLE;
-    VkDeviceMemory m_textureImageMemory = VK_NULL_HANDLE;
+    MemoryAllocation m_textureImageAllocation{};
     uint32_t m_textureWidth = 0;
     uint32_t m_textureHeight = 0;
     std::vector<ImageRect> m_frames{1};
 
+    void upload(uint32_t width, uint32_t height, const void* pixels, TextureUploadBatch* uploadBatch);
+
     void createImage(
         uint32_t width,
         uint32_t height,
@@ -50,19 +66,7 @@ private:
         VkImageUsageFlags usage,
         VkMemoryPropertyFlags properties,
         VkImage& image,
-        VkDeviceMemory& imageMemory);
-
-    void transitionImageLayout(
-        VkImage image,
-        VkFormat format,
-        VkImageLayout oldLayout,
-        VkImageLayout newLayout);
-
-    void copyBufferToImage(
-        Buffer& buffer,
-        VkImage image,
-        uint32_t width,
-        uint32_t height);
+        MemoryAllocation& imageAllocation);
 };
 
 #endif //TEXTURE2D_H
@@ -0,0 +1,134 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include "TextureResidency.h"
+
+#include "TextureUploadBatch.h"
+
+TextureResidency::TextureResidency(
+    const std::weak_ptr<VulkanResources>& resources,
+    const std::filesystem::path& assetsBasePath,
+    const std::filesystem::path& placeholderPath,
+    VkDeviceSize budgetBytes)
+{
+    m_resources = resources;
+    m_statistics.budgetBytes = budgetBytes;
+
+    const AtlasEntry placeholder{ 0, placeholderPath.generic_string(), {} };
+    m_placeholder = std::make_unique<Texture2D>(resources, assetsBasePath, placeholder);
+}
+
+size_t TextureResidency::addTexture(uint32_t width, uint32_t height, std::vector<uint8_t> pixels)
+{
+    m_textures.push_back({ width, height, std::move(pixels), nullptr, 0 });
+    m_statistics.textureCount = m_textures.size();
+
+    return m_textures.size() - 1;
+}
+
+void TextureResidency::reference(size_t texture)
+{
+    ManagedTexture& managed = m_textures[texture];
+
+    // Only the first reference per frame counts, sprites of one page are drawn many times a frame
+    if (managed.lastUsedFrame == m_frame)
+    {
+        return;
+    }
+
+    managed.lastUsedFrame = m_frame;
+
+    if (managed.texture)
+    {
+        m_statistics.hits++;
+    }
+    else
+    {
+        m_statistics.misses++;
+        m_missingTextures.push_back(texture);
+    }
+}
+
+bool TextureResidency::update(VkCommandBuffer commandBuffer, UploadRing& uploadRing)
+{
+    m_changedTextures.clear();
+    VkDeviceSize uploadedBytes = 0;
+    TextureUploadBatch uploadBatch(m_resources);
+
+    for (const size_t texture : m_missingTextures)
+    {
+        ManagedTexture& managed = m_textures[texture];
+        const VkDeviceSize bytes = getBytes(managed);
+
+        // Textures over the upload limit stay on the placeholder and get requested again when they are drawn
+        if (managed.texture || (uploadedBytes > 0 && uploadedBytes + bytes > UPLOAD_BYTES_PER_FRAME))
+        {
+            continue;
+        }
+
+        managed.texture = std::make_unique<Texture2D>(
+            m_resources,
+            managed.width,
+            managed.height,
+            managed.pixels.data(),
+            &uploadBatch);
+
+        uploadedBytes += bytes;
+        m_statistics.residentBytes += bytes;
+        m_statistics.residentTextures++;
+        m_changedTextures.push_back(texture);
+    }
+
+    uploadBatch.record(commandBuffer, uploadRing);
+    m_missingTextures.clear();
+
+    while (m_statistics.residentBytes > m_statistics.budgetBytes)
+    {
+        ManagedTexture* victim = findLeastRecentlyUsed();
+
+        if (!victim)
+        {
+            break;
+        }
+
+        // The image is destroyed through the deletion queue, once frames in flight stopped sampling it
+        victim->texture.reset();
+        m_statistics.residentBytes -= getBytes(*victim);
+        m_statistics.residentTextures--;
+        m_statistics.evictions++;
+        m_changedTextures.push_back(static_cast<size_t>(victim - m_textures.data()));
+    }
+
+    m_frame++;
+
+    return !m_changedTextures.empty();
+}
+
+VkImageView TextureResidency::getImageView(size_t texture) const
+{
+    const ManagedTexture& managed = m_textures[texture];
+
+    return managed.texture ? managed.texture->getImageView() : m_placeholder->getImageView();
+}
+
+TextureResidency::ManagedTexture* TextureResidency::findLeastRecentlyUsed()
+{
+    ManagedTexture* victim = nullptr;
+
+    for (auto& managed : m_textures)
+    {
+        // Textures of the frame about to be recorded stay, even when they alone exceed the budget
+        if (!managed.texture || managed.lastUsedFrame == m_frame)
+        {
+            continue;
+        }
+
+        if (!victim || managed.lastUsedFrame < victim->lastUsedFrame)
+        {
+            victim = &managed;
+        }
+    }
+
+    return victim;
+}
@@ -0,0 +1,102 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef TEXTURERESIDENCY_H
+#define TEXTURERESIDENCY_H
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "Texture2D.h"
+#include "UploadRing.h"
+#include "VulkanResources.h"
+
+typedef struct
+{
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    size_t residentTextures;
+    size_t textureCount;
+    VkDeviceSize residentBytes;
+    VkDeviceSize budgetBytes;
+} TextureResidencyStatistics;
+
+/**
+ * Keeps the pixels of managed textures in system memory and only creates their images once they are referenced.
+ * Until then, and after they were evicted, the placeholder texture stands in for them.
+ * Textures that were not referenced in the current frame are evicted least recently used first once the resident
+ * images exceed the byte budget. Uploads are limited per frame, so a burst of new textures does not stall one frame.
+ */
+class TextureResidency
+{
+public:
+    static constexpr VkDeviceSize DEFAULT_BUDGET = 64 * 1024 * 1024;
+    static constexpr VkDeviceSize UPLOAD_BYTES_PER_FRAME = 16 * 1024 * 1024;
+
+    TextureResidency(
+        const std::weak_ptr<VulkanResources>& resources,
+        const std::filesystem::path& assetsBasePath,
+        const std::filesystem::path& placeholderPath,
+        VkDeviceSize budgetBytes = DEFAULT_BUDGET);
+
+    /**
+     * Takes tightly packed RGBA pixels, returns the index to reference the texture by.
+     */
+    size_t addTexture(uint32_t width, uint32_t height, std::vector<uint8_t> pixels);
+
+    /**
+     * Marks the texture as used by the current frame. Missing textures get uploaded by the next update.
+     */
+    void reference(size_t texture);
+
+    /**
+     * Records the uploads of referenced textures that are missing into commandBuffer and evicts over the budget, then
+     * starts the next frame. New images may only be sampled by commands recorded afterward. Returns whether any image
+     * view changed.
+     */
+    bool update(VkCommandBuffer commandBuffer, UploadRing& uploadRing);
+
+    /**
+     * Textures whose image view changed in the last update.
+     */
+    [[nodiscard]] const std::vector<size_t>& getChangedTextures() const { return m_changedTextures; }
+
+    /**
+     * The placeholder's image view while the texture is not resident.
+     */
+    [[nodiscard]] VkImageView getImageView(size_t texture) const;
+
+    void setBudget(VkDeviceSize budgetBytes) { m_statistics.budgetBytes = budgetBytes; }
+    [[nodiscard]] const TextureResidencyStatistics& getStatistics() const { return m_statistics; }
+
+private:
+    typedef struct
+    {
+        uint32_t width;
+        uint32_t height;
+        std::vector<uint8_t> pixels;
+        std::unique_ptr<Texture2D> texture;
+        uint64_t lastUsedFrame;
+    } ManagedTexture;
+
+    std::weak_ptr<VulkanResources> m_resources;
+    std::unique_ptr<Texture2D> m_placeholder;
+    std::vector<ManagedTexture> m_textures{};
+    std::vector<size_t> m_missingTextures{};
+    std::vector<size_t> m_changedTextures{};
+    uint64_t m_frame = 1;
+    TextureResidencyStatistics m_statistics{};
+
+    [[nodiscard]] static VkDeviceSize getBytes(const ManagedTexture& texture)
+    {
+        return static_cast<VkDeviceSize>(texture.width) * texture.height * 4;
+    }
+
+    ManagedTexture* findLeastRecentlyUsed();
+};
+
+#endif //TEXTURERESIDENCY_H
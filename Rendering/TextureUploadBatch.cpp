@@ -0,0 +1,178 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include "TextureUploadBatch.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "Buffer.h"
+#include "UploadRing.h"
+
+TextureUploadBatch::TextureUploadBatch(const std::weak_ptr<VulkanResources>& resources)
+{
+    m_resources = resources;
+}
+
+void TextureUploadBatch::add(VkImage image, uint32_t width, uint32_t height, const void* pixels)
+{
+    const VkDeviceSize offset = (m_stagedPixels.size() + UPLOAD_ALIGNMENT - 1) & ~(UPLOAD_ALIGNMENT - 1);
+    const VkDeviceSize size = static_cast<VkDeviceSize>(width) * height * 4;
+
+    m_stagedPixels.resize(offset + size);
+    memcpy(m_stagedPixels.data() + offset, pixels, size);
+
+    m_uploads.push_back({ image, width, height, offset });
+}
+
+void TextureUploadBatch::submit()
+{
+    const auto resources = m_resources.lock();
+
+    if (!resources || m_uploads.empty())
+    {
+        return;
+    }
+
+    const Buffer stagingBuffer(
+        m_resources,
+        m_stagedPixels.size(),
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+    stagingBuffer.writeData(m_stagedPixels.data(), m_stagedPixels.size());
+
+    VkDevice device = resources->m_logicalDevice;
+    VkCommandPool commandPool = resources->m_commandPool;
+
+    VkCommandBufferAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+    allocInfo.commandPool = commandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+
+    VkCommandBuffer commandBuffer;
+    vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer);
+
+    VkCommandBufferBeginInfo beginInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+    recordCopies(commandBuffer, stagingBuffer.getBuffer(), 0);
+
+    vkEndCommandBuffer(commandBuffer);
+
+    VkFenceCreateInfo fenceInfo{ VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+    VkFence fence;
+
+    if (vkCreateFence(device, &fenceInfo, resources->m_allocator, &fence) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create texture upload fence!");
+    }
+
+    VkSubmitInfo submitInfo{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+
+    if (vkQueueSubmit(resources->m_graphicsQueue, 1, &submitInfo, fence) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to submit texture uploads!");
+    }
+
+    vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX);
+
+    vkDestroyFence(device, fence, resources->m_allocator);
+    vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
+
+    m_uploads.clear();
+    m_stagedPixels.clear();
+    m_stagedPixels.shrink_to_fit();
+}
+
+void TextureUploadBatch::record(VkCommandBuffer commandBuffer, UploadRing& uploadRing)
+{
+    if (m_uploads.empty())
+    {
+        return;
+    }
+
+    const UploadAllocation staging = uploadRing.upload(m_stagedPixels.data(), m_stagedPixels.size(), UPLOAD_ALIGNMENT);
+    recordCopies(commandBuffer, staging.buffer, staging.offset);
+
+    m_uploads.clear();
+    m_stagedPixels.clear();
+}
+
+void TextureUploadBatch::recordCopies(
+    VkCommandBuffer commandBuffer,
+    VkBuffer stagingBuffer,
+    VkDeviceSize stagingOffset) const
+{
+    std::vector<VkImageMemoryBarrier> barriers{m_uploads.size()};
+
+    for (size_t i = 0; i < m_uploads.size(); i++)
+    {
+        VkImageMemoryBarrier& barrier = barriers[i];
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = m_uploads[i].image;
+        barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+    }
+
+    // All images move to the transfer layout in one barrier batch, then back to shader reads in another
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0,
+        0,
+        nullptr,
+        0,
+        nullptr,
+        static_cast<uint32_t>(barriers.size()),
+        barriers.data());
+
+    for (const auto& upload : m_uploads)
+    {
+        VkBufferImageCopy region{};
+        region.bufferOffset = stagingOffset + upload.offset;
+        region.bufferRowLength = 0;     // tightly packed
+        region.bufferImageHeight = 0;
+        region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+        region.imageOffset = { 0, 0, 0 };
+        region.imageExtent = { upload.width, upload.height, 1 };
+
+        vkCmdCopyBufferToImage(
+            commandBuffer,
+            stagingBuffer,
+            upload.image,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            1,
+            &region);
+    }
+
+    for (auto& barrier : barriers)
+    {
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    }
+
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        0,
+        0,
+        nullptr,
+        0,
+        nullptr,
+        static_cast<uint32_t>(barriers.size()),
+        barriers.data());
+}
@@ -0,0 +1,62 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef TEXTUREUPLOADBATCH_H
+#define TEXTUREUPLOADBATCH_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "VulkanResources.h"
+
+class UploadRing;
+
+/**
+ * Collects the pixels of several images and uploads them with one staging buffer, one command buffer and one fence
+ * wait, instead of a queue round trip per layout transition and copy of every texture.
+ * Images added to the batch must not be sampled before submit returned, or by commands recorded before record.
+ */
+class TextureUploadBatch
+{
+public:
+    explicit TextureUploadBatch(const std::weak_ptr<VulkanResources>& resources);
+
+    /**
+     * Copies tightly packed RGBA pixels of image, which has to be in the undefined layout. The image ends up in the
+     * shader read only layout once the batch was submitted.
+     */
+    void add(VkImage image, uint32_t width, uint32_t height, const void* pixels);
+
+    void submit();
+
+    /**
+     * Records the uploads into commandBuffer, staged through the upload ring, instead of submitting them on their own.
+     */
+    void record(VkCommandBuffer commandBuffer, UploadRing& uploadRing);
+
+    [[nodiscard]] size_t getImageCount() const { return m_uploads.size(); }
+    [[nodiscard]] VkDeviceSize getStagedBytes() const { return m_stagedPixels.size(); }
+
+private:
+    typedef struct
+    {
+        VkImage image;
+        uint32_t width;
+        uint32_t height;
+        VkDeviceSize offset;
+    } PendingUpload;
+
+    // Keeps every copy source aligned for any texel format and optimalBufferCopyOffsetAlignment
+    static constexpr VkDeviceSize UPLOAD_ALIGNMENT = 16;
+
+    std::weak_ptr<VulkanResources> m_resources;
+    std::vector<PendingUpload> m_uploads{};
+    std::vector<uint8_t> m_stagedPixels{};
+
+    void recordCopies(VkCommandBuffer commandBuffer, VkBuffer stagingBuffer, VkDeviceSize stagingOffset) const;
+};
+
+#endif //TEXTUREUPLOADBATCH_H
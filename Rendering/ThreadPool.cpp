@@ -0,0 +1,76 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+#include "CpuProfiler.h"
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+    // The main thread keeps working while the pool runs, so it does not get a worker of its own
+    if (threadCount == 0)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+
+    m_workers.reserve(threadCount);
+
+    for (uint32_t i = 0; i < threadCount; i++)
+    {
+        m_workers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+
+    m_condition.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::enqueue(std::coroutine_handle<> handle, TaskPriority priority)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_queue.push({ priority, m_nextSequence++, handle });
+    }
+
+    m_condition.notify_one();
+}
+
+void ThreadPool::work()
+{
+    PROFILE_THREAD_NAME("Asset worker");
+
+    while (true)
+    {
+        std::coroutine_handle<> handle;
+
+        {
+            std::unique_lock lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+
+            if (m_queue.empty())
+            {
+                return;
+            }
+
+            handle = m_queue.top().handle;
+            m_queue.pop();
+        }
+
+        PROFILE_SCOPE("Task");
+        handle.resume();
+    }
+}
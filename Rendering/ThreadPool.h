@@ -0,0 +1,86 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+enum class TaskPriority : uint8_t
+{
+    Low,
+    Normal,
+    High
+};
+
+/**
+ * Worker threads that resume coroutines, higher priorities first and in submission order within a priority.
+ * The destructor finishes all queued work before joining the workers.
+ */
+class ThreadPool
+{
+public:
+    explicit ThreadPool(uint32_t threadCount = 0);
+    ~ThreadPool();
+
+    /**
+     * Awaiting the result continues the coroutine on one of the workers.
+     */
+    auto schedule(TaskPriority priority = TaskPriority::Normal)
+    {
+        struct Awaiter
+        {
+            ThreadPool& pool;
+            TaskPriority priority;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) const { pool.enqueue(handle, priority); }
+            void await_resume() const noexcept {}
+        };
+
+        return Awaiter{ *this, priority };
+    }
+
+    void enqueue(std::coroutine_handle<> handle, TaskPriority priority);
+
+    [[nodiscard]] size_t getThreadCount() const { return m_workers.size(); }
+
+private:
+    typedef struct
+    {
+        TaskPriority priority;
+        uint64_t sequence;
+        std::coroutine_handle<> handle;
+    } QueuedWork;
+
+    struct QueuedWorkOrder
+    {
+        bool operator()(const QueuedWork& a, const QueuedWork& b) const
+        {
+            if (a.priority != b.priority)
+            {
+                return a.priority < b.priority;
+            }
+
+            return a.sequence > b.sequence;
+        }
+    };
+
+    std::vector<std::thread> m_workers{};
+    std::priority_queue<QueuedWork, std::vector<QueuedWork>, QueuedWorkOrder> m_queue{};
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    uint64_t m_nextSequence = 0;
+    bool m_stopping = false;
+
+    void work();
+};
+
+#endif //THREADPOOL_H
@@ -0,0 +1,281 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include "TilemapRenderer.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+#include "Shader.h"
+
+TilemapRenderer::TilemapRenderer(
+    const std::weak_ptr<VulkanResources>& resources,
+    const std::filesystem::path& vertexShaderPath,
+    const std::filesystem::path& fragmentShaderPath,
+    VkFormat colorFormat)
+{
+    m_resources = resources;
+
+    const auto ptr = resources.lock();
+
+    if (!ptr)
+    {
+        return;
+    }
+
+    m_textureDescriptorSet = ptr->m_textureTable->getDescriptorSet();
+
+    initializeDescriptorSetLayout(ptr->m_logicalDevice, ptr->m_allocator);
+    initializePipelineLayout(ptr->m_logicalDevice, ptr->m_allocator);
+
+    const Shader shader(ptr->m_logicalDevice, vertexShaderPath, fragmentShaderPath);
+    m_pipeline = std::make_unique<Pipeline>(resources, shader, colorFormat, 0, false, m_pipelineLayout);
+}
+
+TilemapRenderer::~TilemapRenderer()
+{
+    const auto ptr = m_resources.lock();
+
+    if (!ptr)
+    {
+        return;
+    }
+
+    m_pipeline.reset();
+    m_tileBuffer.reset();
+
+    if (m_descriptorSet != VK_NULL_HANDLE)
+    {
+        ptr->m_deletionQueue->freeDescriptorSet(ptr->m_descriptorPool, m_descriptorSet);
+    }
+
+    vkDestroyPipelineLayout(ptr->m_logicalDevice, m_pipelineLayout, ptr->m_allocator);
+    vkDestroyDescriptorSetLayout(ptr->m_logicalDevice, m_descriptorSetLayout, ptr->m_allocator);
+}
+
+void TilemapRenderer::initializeDescriptorSetLayout(VkDevice device, const VkAllocationCallbacks* allocator)
+{
+    VkDescriptorSetLayoutBinding tilesBinding{};
+    tilesBinding.binding = 0;
+    tilesBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    tilesBinding.descriptorCount = 1;
+    tilesBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutCreateInfo createInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    createInfo.bindingCount = 1;
+    createInfo.pBindings = &tilesBinding;
+
+    if (vkCreateDescriptorSetLayout(device, &createInfo, allocator, &m_descriptorSetLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create tilemap descriptor set layout");
+    }
+}
+
+void TilemapRenderer::initializePipelineLayout(VkDevice device, const VkAllocationCallbacks* allocator)
+{
+    const auto resources = m_resources.lock();
+
+    // Set 0 is the scene set of the sprite pipelines with the camera and the frame table, set 2 the texture table
+    std::array layouts =
+    {
+        resources->m_descriptorSetLayout,
+        m_descriptorSetLayout,
+        resources->m_textureTable->getLayout()
+    };
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(TilemapParameters);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(layouts.size());
+    pipelineLayoutInfo.pSetLayouts = layouts.data();
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, allocator, &m_pipelineLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create tilemap pipeline layout");
+    }
+}
+
+bool TilemapRenderer::update(const Map& map, std::span<const uint32_t> textureFirstFrames)
+{
+    if (map.getRevision() == m_revision)
+    {
+        return false;
+    }
+
+    const auto ptr = m_resources.lock();
+
+    if (!ptr)
+    {
+        return false;
+    }
+
+    const uint32_t previousColumns = m_columns;
+    const uint32_t previousRows = m_rows;
+    const size_t previousLayerCount = m_layerCount;
+
+    m_revision = map.getRevision();
+    m_columns = static_cast<uint32_t>(map.getColumns());
+    m_rows = static_cast<uint32_t>(map.getRows());
+
+    // Layers are drawn in ascending order of their layer value, unused values get no slot
+    std::array<int32_t, 256> layerSlots{};
+    layerSlots.fill(-1);
+
+    for (const auto& tile : map.getTiles())
+    {
+        for (const auto& tileLayer : tile.tileLayers)
+        {
+            layerSlots[tileLayer.layer] = 0;
+        }
+    }
+
+    m_layerCount = 0;
+
+    for (auto& slot : layerSlots)
+    {
+        if (slot >= 0)
+        {
+            slot = static_cast<int32_t>(m_layerCount++);
+        }
+    }
+
+    const size_t tilesPerLayer = static_cast<size_t>(m_columns) * m_rows;
+    m_previousTileIds.swap(m_tileIds);
+    m_tileIds.assign(std::max<size_t>(tilesPerLayer * m_layerCount, 1), 0);
+
+    for (const auto& tile : map.getTiles())
+    {
+        const size_t tileIndex = tile.column + tile.row * m_columns;
+
+        for (const auto& tileLayer : tile.tileLayers)
+        {
+            if (tileLayer.sprite.textureIndex >= textureFirstFrames.size())
+            {
+                continue;
+            }
+
+            const size_t slot = layerSlots[tileLayer.layer];
+            const uint32_t frameIndex =
+                textureFirstFrames[tileLayer.sprite.textureIndex] + tileLayer.sprite.currentFrame;
+
+            m_tileIds[slot * tilesPerLayer + tileIndex] = frameIndex + 1;
+        }
+    }
+
+    m_changedTiles.clear();
+    m_allTilesChanged =
+        m_columns != previousColumns || m_rows != previousRows || m_layerCount != previousLayerCount;
+
+    if (!m_allTilesChanged)
+    {
+        for (size_t i = 0; i < m_tileIds.size(); i++)
+        {
+            if (m_tileIds[i] != m_previousTileIds[i])
+            {
+                m_changedTiles.push_back(static_cast<uint32_t>(i % std::max<size_t>(tilesPerLayer, 1)));
+            }
+        }
+    }
+
+    // Frames in flight keep reading the previous buffer and set until the deletion queue releases them
+    const VkDeviceSize tileBufferSize = m_tileIds.size() * sizeof(uint32_t);
+    m_tileBuffer = std::make_unique<Buffer>(
+        m_resources,
+        tileBufferSize,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    m_tileBuffer->writeData(m_tileIds.data(), tileBufferSize);
+
+    writeDescriptor(*ptr);
+
+    return true;
+}
+
+void TilemapRenderer::writeDescriptor(VulkanResources& resources)
+{
+    if (m_descriptorSet != VK_NULL_HANDLE)
+    {
+        resources.m_deletionQueue->freeDescriptorSet(resources.m_descriptorPool, m_descriptorSet);
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    allocInfo.descriptorPool = resources.m_descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &m_descriptorSetLayout;
+
+    if (vkAllocateDescriptorSets(resources.m_logicalDevice, &allocInfo, &m_descriptorSet) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to allocate tilemap descriptor set!");
+    }
+
+    VkDescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = m_tileBuffer->getBuffer();
+    bufferInfo.offset = 0;
+    bufferInfo.range = VK_WHOLE_SIZE;
+
+    VkWriteDescriptorSet descriptorWrite{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+    descriptorWrite.dstSet = m_descriptorSet;
+    descriptorWrite.dstBinding = 0;
+    descriptorWrite.dstArrayElement = 0;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pBufferInfo = &bufferInfo;
+
+    vkUpdateDescriptorSets(resources.m_logicalDevice, 1, &descriptorWrite, 0, nullptr);
+}
+
+void TilemapRenderer::record(
+    VkCommandBuffer commandBuffer,
+    VkDescriptorSet sceneDescriptorSet,
+    uint32_t indexCount,
+    const glm::mat4& viewProjection) const
+{
+    if (m_layerCount == 0 || m_descriptorSet == VK_NULL_HANDLE || sceneDescriptorSet == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline->getPipeline());
+
+    const std::array descriptorSets = { sceneDescriptorSet, m_descriptorSet, m_textureDescriptorSet };
+
+    vkCmdBindDescriptorSets(
+        commandBuffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        m_pipelineLayout,
+        0,
+        static_cast<uint32_t>(descriptorSets.size()),
+        descriptorSets.data(),
+        0,
+        nullptr);
+
+    const size_t tilesPerLayer = static_cast<size_t>(m_columns) * m_rows;
+
+    for (size_t layer = 0; layer < m_layerCount; layer++)
+    {
+        const TilemapParameters parameters
+        {
+            viewProjection,
+            m_columns,
+            m_rows,
+            static_cast<uint32_t>(layer * tilesPerLayer)
+        };
+
+        vkCmdPushConstants(
+            commandBuffer,
+            m_pipelineLayout,
+            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+            0,
+            sizeof(TilemapParameters),
+            &parameters);
+
+        vkCmdDrawIndexed(commandBuffer, indexCount, 1, 0, 0, 0);
+    }
+}
@@ -0,0 +1,100 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef TILEMAPRENDERER_H
+#define TILEMAPRENDERER_H
+
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+#include "Buffer.h"
+#include "Pipeline.h"
+#include "VulkanResources.h"
+#include "../Core/Map.h"
+
+/**
+ * Draws every layer of a map with a single quad instead of one sprite instance per tile.
+ * The tiles of all layers live in one storage buffer as frame table indices plus one, zero marks an empty tile.
+ * The fragment shader finds the tile under each pixel, looks up its frame and samples the texture, so the recorded
+ * work per frame only depends on the number of layers. The buffer is rebuilt when the map revision changes.
+ */
+class TilemapRenderer
+{
+public:
+    TilemapRenderer(
+        const std::weak_ptr<VulkanResources>& resources,
+        const std::filesystem::path& vertexShaderPath,
+        const std::filesystem::path& fragmentShaderPath,
+        VkFormat colorFormat);
+    ~TilemapRenderer();
+
+    /**
+     * Uploads the tiles of map unless this revision is already on the GPU. Returns whether it uploaded.
+     * textureFirstFrames maps a texture index to the frame table index of its first frame.
+     */
+    bool update(const Map& map, std::span<const uint32_t> textureFirstFrames);
+
+    /**
+     * Expects the default quad to be bound as vertex and index buffer. viewProjection maps world units to clip space,
+     * which lets the chunk cache render parts of the map into its own images.
+     */
+    void record(
+        VkCommandBuffer commandBuffer,
+        VkDescriptorSet sceneDescriptorSet,
+        uint32_t indexCount,
+        const glm::mat4& viewProjection) const;
+
+    [[nodiscard]] size_t getLayerCount() const { return m_layerCount; }
+    [[nodiscard]] uint32_t getColumns() const { return m_columns; }
+    [[nodiscard]] uint32_t getRows() const { return m_rows; }
+
+    /**
+     * Frame table index plus one of every tile, layer after layer, zero for empty tiles.
+     */
+    [[nodiscard]] const std::vector<uint32_t>& getTileIds() const { return m_tileIds; }
+
+    /**
+     * Tiles, as index into a single layer, whose id changed on any layer in the last update that uploaded.
+     * When the size or the layers of the map changed, every tile counts as changed instead.
+     */
+    [[nodiscard]] const std::vector<uint32_t>& getChangedTiles() const { return m_changedTiles; }
+    [[nodiscard]] bool haveAllTilesChanged() const { return m_allTilesChanged; }
+
+private:
+    typedef struct
+    {
+        glm::mat4 viewProjection;
+        uint32_t columns;
+        uint32_t rows;
+        uint32_t firstTile;
+    } TilemapParameters;
+
+    std::weak_ptr<VulkanResources> m_resources;
+    VkDescriptorSetLayout m_descriptorSetLayout = VK_NULL_HANDLE;
+    VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+    std::unique_ptr<Pipeline> m_pipeline;
+
+    VkDescriptorSet m_descriptorSet = VK_NULL_HANDLE;
+    VkDescriptorSet m_textureDescriptorSet = VK_NULL_HANDLE;
+    std::unique_ptr<Buffer> m_tileBuffer;
+    std::vector<uint32_t> m_tileIds{};
+    std::vector<uint32_t> m_previousTileIds{};
+    std::vector<uint32_t> m_changedTiles{};
+    bool m_allTilesChanged = false;
+
+    uint64_t m_revision = 0;
+    uint32_t m_columns = 0;
+    uint32_t m_rows = 0;
+    size_t m_layerCount = 0;
+
+    void initializeDescriptorSetLayout(VkDevice device, const VkAllocationCallbacks* allocator);
+    void initializePipelineLayout(VkDevice device, const VkAllocationCallbacks* allocator);
+    void writeDescriptor(VulkanResources& resources);
+};
+
+#endif //TILEMAPRENDERER_H
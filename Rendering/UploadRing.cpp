@@ -0,0 +1,128 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#include "UploadRing.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "VulkanHelpers.h"
+
+UploadRing::UploadRing(
+    const std::weak_ptr<VulkanResources>& resources,
+    VkDeviceSize capacity)
+{
+    m_resources = resources;
+    createBuffer(capacity);
+}
+
+void UploadRing::beginFrame(size_t frameSlot)
+{
+    // The queue finishes frames in submission order, so once this slot is free again
+    // every frame submitted before its last use is done as well.
+    size_t reclaimableFrames = 0;
+
+    for (size_t i = 0; i < m_frames.size(); i++)
+    {
+        if (m_frames[i].frameSlot == frameSlot)
+        {
+            reclaimableFrames = i + 1;
+        }
+    }
+
+    for (size_t i = 0; i < reclaimableFrames; i++)
+    {
+        m_usedBytes -= m_frames.front().consumedBytes;
+        m_frames.pop_front();
+    }
+
+    m_frames.push_back({ frameSlot, 0 });
+    m_frameUploadedBytes = 0;
+}
+
+UploadAllocation UploadRing::allocate(VkDeviceSize size, VkDeviceSize alignment)
+{
+    if (m_frames.empty())
+    {
+        throw std::runtime_error("Upload ring allocation outside of a frame");
+    }
+
+    VkDeviceSize offset = VulkanHelpers::alignUp(m_head, alignment);
+    VkDeviceSize consumedBytes = (offset - m_head) + size;
+
+    if (offset + size > m_capacity)
+    {
+        // Wrap around, the unused tail of the buffer counts towards this frame until it is reclaimed
+        offset = 0;
+        consumedBytes = (m_capacity - m_head) + size;
+    }
+
+    if (m_usedBytes + consumedBytes > m_capacity)
+    {
+        grow(size + alignment);
+        offset = 0;
+        consumedBytes = size;
+    }
+
+    m_head = offset + size;
+    m_usedBytes += consumedBytes;
+    m_frames.back().consumedBytes += consumedBytes;
+    m_frameUploadedBytes += size;
+
+    return UploadAllocation
+    {
+        m_buffer->getBuffer(),
+        offset,
+        size,
+        static_cast<char*>(m_buffer->getMappedMemory()) + offset
+    };
+}
+
+UploadAllocation UploadRing::upload(const void* data, VkDeviceSize size, VkDeviceSize alignment)
+{
+    const UploadAllocation allocation = allocate(size, alignment);
+
+    memcpy(allocation.data, data, size);
+    flush(allocation);
+
+    return allocation;
+}
+
+void UploadRing::flush(const UploadAllocation& allocation) const
+{
+    m_buffer->flush(allocation.offset, allocation.size);
+}
+
+void UploadRing::createBuffer(VkDeviceSize capacity)
+{
+    m_capacity = capacity;
+    m_buffer = std::make_unique<Buffer>(
+        m_resources,
+        capacity,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+}
+
+void UploadRing::grow(VkDeviceSize minimumCapacity)
+{
+    VkDeviceSize capacity = std::max<VkDeviceSize>(m_capacity * 2, 1);
+
+    while (capacity < minimumCapacity)
+    {
+        capacity *= 2;
+    }
+
+    // Allocations of the frames in flight, including the current one, stay valid until the deletion queue
+    // destroys the old buffer
+    createBuffer(capacity);
+
+    for (auto& frame : m_frames)
+    {
+        frame.consumedBytes = 0;
+    }
+
+    m_head = 0;
+    m_usedBytes = 0;
+}
@@ -0,0 +1,71 @@
+//
+// Created by patri on 19.10.2026.
+//
+
+#ifndef UPLOADRING_H
+#define UPLOADRING_H
+
+#include <deque>
+#include <memory>
+#include <vulkan/vulkan.h>
+
+#include "Buffer.h"
+#include "VulkanResources.h"
+
+typedef struct
+{
+    VkBuffer buffer;
+    VkDeviceSize offset;
+    VkDeviceSize size;
+    void* data;
+} UploadAllocation;
+
+/**
+ * Linear allocator over one persistently mapped buffer that is shared by all per frame uploads.
+ * Every frame sub-allocates aligned ranges behind the ones of the previous frames. The ranges of a frame are reclaimed
+ * when the same frame slot begins again, which the renderer only does after waiting for that slot's timeline value.
+ * When a frame needs more than is free, the ring switches to a buffer twice the size. The old one is released through
+ * the deletion queue once the frames that allocated from it have finished.
+ */
+class UploadRing
+{
+public:
+    UploadRing(
+        const std::weak_ptr<VulkanResources>& resources,
+        VkDeviceSize capacity);
+
+    void beginFrame(size_t frameSlot);
+
+    [[nodiscard]] UploadAllocation allocate(VkDeviceSize size, VkDeviceSize alignment);
+    UploadAllocation upload(const void* data, VkDeviceSize size, VkDeviceSize alignment);
+    void flush(const UploadAllocation& allocation) const;
+
+    [[nodiscard]] VkBuffer getBuffer() const { return m_buffer->getBuffer(); }
+    [[nodiscard]] VkDeviceSize getCapacity() const { return m_capacity; }
+    [[nodiscard]] VkDeviceSize getUsedBytes() const { return m_usedBytes; }
+
+    /**
+     * Bytes allocated since the last beginFrame, without alignment padding.
+     */
+    [[nodiscard]] VkDeviceSize getFrameUploadedBytes() const { return m_frameUploadedBytes; }
+
+private:
+    typedef struct
+    {
+        size_t frameSlot;
+        VkDeviceSize consumedBytes;
+    } FrameRecord;
+
+    std::weak_ptr<VulkanResources> m_resources;
+    std::unique_ptr<Buffer> m_buffer;
+    VkDeviceSize m_capacity = 0;
+    VkDeviceSize m_head = 0;
+    VkDeviceSize m_usedBytes = 0;
+    VkDeviceSize m_frameUploadedBytes = 0;
+    std::deque<FrameRecord> m_frames{};
+
+    void createBuffer(VkDeviceSize capacity);
+    void grow(VkDeviceSize minimumCapacity);
+};
+
+#endif //UPLOADRING_H
@@ -9,6 +9,7 @@
 #include <vector>
 #include <stdexcept>
 #include <cstring>
+#include <optional>
 
 class VulkanHelpers
 {
@@ -69,6 +70,44 @@ public:
 
         throw std::runtime_error("Failed to find suitable memory type");
     }
+
+    static std::optional<uint32_t> tryFindMemoryType(
+        const VkPhysicalDeviceMemoryProperties& memoryProperties,
+        uint32_t typeFilter,
+        VkMemoryPropertyFlags properties)
+    {
+        for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+        {
+            const auto maskedProperties = (memoryProperties.memoryTypes[i].propertyFlags & properties);
+
+            if (typeFilter & (1 << i) && maskedProperties == properties)
+            {
+                return i;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    static VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment)
+    {
+        if (alignment == 0)
+        {
+            return value;
+        }
+
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    static VkDeviceSize alignDown(VkDeviceSize value, VkDeviceSize alignment)
+    {
+        if (alignment == 0)
+        {
+            return value;
+        }
+
+        return value / alignment * alignment;
+    }
 };
 
 
@@ -8,10 +8,21 @@
 #define GLFW_EXPOSE_NATIVE_WIN32
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 
-#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <numeric>
+#include <thread>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "AtlasPacker.h"
+#include "CpuProfiler.h"
+#include "Logger.h"
+#include "PngWriter.h"
+#include "Shader.h"
 #include "CameraUniformData.h"
+#include "TextureUploadBatch.h"
 #include "VulkanResources.h"
 #include "VulkanWindow.h"
 #include "GLFW/glfw3native.h"
@@ -33,46 +44,58 @@ VulkanRenderer::VulkanRenderer(
 
 VulkanRenderer::~VulkanRenderer()
 {
-    const auto device = m_vulkanResources->m_logicalDevice;
-    const auto allocator = m_vulkanResources->m_allocator;
-    const auto& descriptorPool =  m_vulkanResources->m_descriptorPool;
-
-    vkDeviceWaitIdle(device);
-
-    m_cameraBuffers.clear();
+    // Everything goes through the deletion queue, which VulkanResources drains once the device is idle
+    auto& deletionQueue = *m_vulkanResources->m_deletionQueue;
+
+    m_uploadRing.reset();
+    m_cullingPass.reset();
+    m_gpuProfiler.reset();
+    m_chunkCache.reset();
+    m_tilemapRenderer.reset();
+    m_textureResidency.reset();
     m_textures.clear();
+    m_frameTableBuffer.reset();
+    m_instanceIndexBuffer.reset();
     m_vertexBuffers.clear();
     m_indexBuffers.clear();
     m_pipelines.clear();
+    m_objectBuffers.clear();
+
+    for (const auto descriptorSet : m_sceneDataDescriptorSets)
+    {
+        if (descriptorSet != VK_NULL_HANDLE)
+        {
+            deletionQueue.freeDescriptorSet(m_vulkanResources->m_descriptorPool, descriptorSet);
+        }
+    }
+
+    for (const auto descriptorSet : m_frameDataDescriptorSets)
+    {
+        deletionQueue.freeDescriptorSet(m_vulkanResources->m_descriptorPool, descriptorSet);
+    }
 
-    vkFreeDescriptorSets(
-        device,
-        descriptorPool,
-        m_sceneDataDescriptorSets.size(),
-        m_sceneDataDescriptorSets.data());
     m_sceneDataDescriptorSets.clear();
+    m_frameDataDescriptorSets.clear();
 
-    vkDestroySampler(device, m_sampler, allocator);
+    deletionQueue.destroySampler(m_sampler);
 }
 
 void VulkanRenderer::initialize()
 {
-    const auto swapchain = m_vulkanResources->getSwapchain().lock();
-    m_imageCount = swapchain->getImageCount();
+    const VkFormat colorFormat = m_vulkanResources->getColorFormat();
+    m_framesInFlight = m_vulkanResources->m_frameRing->getFramesInFlight();
 
     initializeSampler();
     initializeDefaultMeshes();
 
-    const auto imageCount = swapchain->getImageCount();
-    m_cameraBuffers.reserve(imageCount);
-    m_sceneDataDescriptorSets.resize(imageCount);
-    m_frameDataDescriptorSets.resize(imageCount);
+    m_sceneDataDescriptorSets.resize(m_framesInFlight);
+    m_frameDataDescriptorSets.resize(m_framesInFlight);
 
-    std::vector<VkDescriptorSetLayout> layouts(imageCount, m_vulkanResources->m_descriptorSetLayoutFrameGlobals);
+    std::vector<VkDescriptorSetLayout> layouts(m_framesInFlight, m_vulkanResources->m_descriptorSetLayoutFrameGlobals);
     VkDescriptorSetAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
     allocInfo.descriptorPool = m_vulkanResources->m_descriptorPool;
-    allocInfo.descriptorSetCount = imageCount;
+    allocInfo.descriptorSetCount = static_cast<uint32_t>(m_framesInFlight);
     allocInfo.pSetLayouts = layouts.data();
 
     const auto result = vkAllocateDescriptorSets(
@@ -85,44 +108,75 @@ void VulkanRenderer::initialize()
         throw std::runtime_error("failed to allocate descriptor sets!");
     }
 
-    for (int i = 0; i < imageCount; i++)
+    m_uploadRing = std::make_unique<UploadRing>(m_vulkanResources, UPLOAD_RING_SIZE);
+
+    m_textureResidency = std::make_unique<TextureResidency>(
+        m_vulkanResources,
+        m_assetsBasePath,
+        "Textures/default_texture.jpg");
+
+    const auto tilemapShaderDirectory = Shader::getBinaryDirectory() / "Tilemap";
+
+    // The build compiles these along with the other shaders, so a missing binary means a broken build
+    if (!std::filesystem::exists(tilemapShaderDirectory / "tilemap_vert.spv") ||
+        !std::filesystem::exists(tilemapShaderDirectory / "tilemap_frag.spv"))
     {
-        m_cameraBuffers.emplace_back(
-            std::make_unique<Buffer>(
-                m_vulkanResources,
-                sizeof(CameraUniformData),
-                VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
+        throw std::runtime_error("Tilemap shaders not found in " + tilemapShaderDirectory.string());
+    }
 
-        m_instanceIndexBuffers.emplace_back(
-            std::make_unique<Buffer>(
-                m_vulkanResources,
-                sizeof(uint32_t) * 10000, // TODO: Make this more dynamic and potentially resizable
-                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+    m_tilemapRenderer = std::make_unique<TilemapRenderer>(
+        m_vulkanResources,
+        tilemapShaderDirectory / "tilemap_vert.spv",
+        tilemapShaderDirectory / "tilemap_frag.spv",
+        colorFormat);
 
-        const auto set = m_frameDataDescriptorSets[i];
-        VkDescriptorBufferInfo bufferInfo{};
-        bufferInfo.buffer = m_instanceIndexBuffers[i]->getBuffer();
-        bufferInfo.offset = 0;
-        bufferInfo.range = m_instanceIndexBuffers[i]->getSize();
-
-        std::array<VkWriteDescriptorSet, 1> descriptorWrites{};
-        descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrites[0].dstSet = set;
-        descriptorWrites[0].dstBinding = 0;
-        descriptorWrites[0].dstArrayElement = 0;
-        descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-        descriptorWrites[0].descriptorCount = 1;
-        descriptorWrites[0].pBufferInfo = &bufferInfo;
-
-        vkUpdateDescriptorSets(
-            m_vulkanResources->m_logicalDevice,
-            static_cast<uint32_t>(descriptorWrites.size()),
-            descriptorWrites.data(),
-            0,
-            nullptr);
+    if (!std::filesystem::exists(tilemapShaderDirectory / "chunk_vert.spv") ||
+        !std::filesystem::exists(tilemapShaderDirectory / "chunk_frag.spv"))
+    {
+        throw std::runtime_error("Chunk shaders not found in " + tilemapShaderDirectory.string());
+    }
+
+    m_chunkCache = std::make_unique<ChunkCache>(
+        m_vulkanResources,
+        tilemapShaderDirectory / "chunk_vert.spv",
+        tilemapShaderDirectory / "chunk_frag.spv",
+        colorFormat);
+
+    const auto cullingShaderPath = Shader::getBinaryDirectory() / "Culling" / "cull_comp.spv";
+
+    if (!m_vulkanResources->m_enabledFeatures.drawIndirectFirstInstance)
+    {
+        Logger::log(
+            LogLevel::Warning,
+            "Renderer",
+            "drawIndirectFirstInstance is not supported, culling stays on the CPU");
+    }
+    else if (!std::filesystem::exists(cullingShaderPath))
+    {
+        Logger::log(
+            LogLevel::Warning,
+            "Renderer",
+            "Culling shader {} not found, culling stays on the CPU",
+            cullingShaderPath);
     }
+    else
+    {
+        m_cullingPass = std::make_unique<CullingPass>(m_vulkanResources, cullingShaderPath, m_framesInFlight);
+    }
+
+    m_gpuProfiler = std::make_unique<GpuProfiler>(m_vulkanResources, m_framesInFlight);
+
+    if (!m_gpuProfiler->isAvailable())
+    {
+        Logger::log(
+            LogLevel::Warning,
+            "Renderer",
+            "The graphics queue has no timestamps, GPU profiling is unavailable");
+    }
+
+    m_drawKeys.reserve(INITIAL_DRAW_CAPACITY);
+    m_drawKeysScratch.reserve(INITIAL_DRAW_CAPACITY);
+    m_instanceIndices.reserve(INITIAL_DRAW_CAPACITY);
 }
 
 void VulkanRenderer::initializeDefaultMeshes()
@@ -144,31 +198,276 @@ void VulkanRenderer::initializeDefaultMeshes()
 
 size_t VulkanRenderer::loadTexture(const AtlasEntry& spriteInfo)
 {
-    m_textures.emplace_back(std::make_unique<Texture2D>(m_vulkanResources, m_assetsBasePath, spriteInfo));
+    return loadTextures(std::span(&spriteInfo, 1)).front();
+}
 
-    const auto swapchain = m_vulkanResources->getSwapchain().lock();
-    const size_t imageCount = swapchain->getImageCount();
+std::vector<size_t> VulkanRenderer::loadTextures(std::span<const AtlasEntry> spriteInfos)
+{
+    const auto start = std::chrono::high_resolution_clock::now();
 
-    for (size_t i = 0; i < imageCount; i++)
+    TextureUploadBatch uploadBatch(m_vulkanResources);
+    std::vector<size_t> textureIndices{};
+    textureIndices.reserve(spriteInfos.size());
+
+    for (const auto& spriteInfo : spriteInfos)
     {
+        auto texture = std::make_unique<Texture2D>(m_vulkanResources, m_assetsBasePath, spriteInfo, &uploadBatch);
+        const VkImageView imageView = texture->getImageView();
+        const size_t frameCount = texture->getFrameCount();
+        std::vector<ImageRect> frames{};
+
+        for (size_t i = 0; i < frameCount; i++)
+        {
+            frames.push_back(texture->getFrame(i));
+        }
+
+        const uint32_t textureIndex = addTextureSlot(imageView, std::move(texture), UNMANAGED_TEXTURE);
+        m_textureFirstFrames.push_back(static_cast<uint32_t>(m_frameTable.size()));
+        textureIndices.push_back(m_textureFirstFrames.size() - 1);
+
+        for (const auto& rect : frames)
+        {
+            FrameTableEntry frame{};
+            frame.rect = rect;
+            frame.textureIndex = textureIndex;
+            m_frameTable.push_back(frame);
+        }
+    }
+
+    const VkDeviceSize stagedBytes = uploadBatch.getStagedBytes();
+    uploadBatch.submit();
+    uploadFrameTable();
+    writeSceneDescriptorSets();
+
+    Logger::log(
+        LogLevel::Info,
+        "Renderer",
+        "Uploaded {} textures ({} KiB) in {} ms",
+        spriteInfos.size(),
+        stagedBytes / 1024,
+        std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count());
+
+    return textureIndices;
+}
+
+void VulkanRenderer::createPipelines()
+{
+    if (m_pendingPipelines.empty())
+    {
+        return;
+    }
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    const VkFormat format = m_vulkanResources->getColorFormat();
+    const VkDevice device = m_vulkanResources->m_logicalDevice;
+
+    std::vector<std::exception_ptr> errors(m_pendingPipelines.size());
+    std::atomic<size_t> nextPipeline = 0;
+
+    // Every worker only writes the slots of the pipelines it took, m_pipelines itself is not resized meanwhile
+    const auto createPending = [&]()
+    {
+        for (size_t i = nextPipeline++; i < m_pendingPipelines.size(); i = nextPipeline++)
+        {
+            const PendingPipeline& pending = m_pendingPipelines[i];
+
+            try
+            {
+                const Shader shader(device, pending.vertexShaderPath, pending.fragmentShaderPath);
+
+                m_pipelines[pending.pipelineIndex] = std::make_unique<Pipeline>(
+                    m_vulkanResources,
+                    shader,
+                    format,
+                    pending.dataBufferIndex,
+                    pending.gpuCulled);
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    const size_t threadCount = std::clamp<size_t>(
+        std::thread::hardware_concurrency(),
+        1,
+        m_pendingPipelines.size());
+
+    {
+        std::vector<std::jthread> workers{};
+
+        for (size_t i = 1; i < threadCount; i++)
+        {
+            workers.emplace_back(createPending);
+        }
+
+        createPending();
+    }
+
+    const PipelineCache& cache = *m_vulkanResources->m_pipelineCache;
+
+    Logger::log(
+        LogLevel::Info,
+        "Renderer",
+        "Created {} pipelines on {} threads in {} ms, pipeline cache {} ({} KiB loaded)",
+        m_pendingPipelines.size(),
+        threadCount,
+        std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count(),
+        cache.isWarm() ? "warm" : "cold",
+        cache.getLoadedBytes() / 1024);
+
+    m_pendingPipelines.clear();
+
+    for (const auto& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+std::vector<size_t> VulkanRenderer::loadAtlas(const LoadedAtlas& atlas)
+{
+    const auto& entries = atlas.entries;
+
+    const uint32_t pageSize = std::min<uint32_t>(
+        ATLAS_PAGE_SIZE,
+        m_vulkanResources->m_physicalDeviceProperties.limits.maxImageDimension2D);
+
+    const AtlasPacker packer(pageSize, ATLAS_PADDING);
+    const AtlasPackResult packResult = packer.pack(entries);
+
+    std::vector<std::vector<uint8_t>> pages{packResult.pageHeights.size()};
+
+    for (size_t page = 0; page < pages.size(); page++)
+    {
+        pages[page].resize(static_cast<size_t>(packResult.pageWidth) * packResult.pageHeights[page] * 4);
+    }
+
+    for (size_t entry = 0; entry < entries.size(); entry++)
+    {
+        const ImageInfo& image = *atlas.images[entry];
+
+        for (size_t frame = 0; frame < entries[entry].frames.size(); frame++)
+        {
+            const AtlasFrame& source = entries[entry].frames[frame];
+            const AtlasPlacement& placement = packResult.placements[entry][frame];
+            auto& pixels = pages[placement.page];
+
+            // The padding repeats the frame's border texels, so filtering at the edge stays inside the frame
+            const int32_t padding = static_cast<int32_t>(ATLAS_PADDING);
+
+            for (int32_t y = -padding; y < static_cast<int32_t>(placement.height) + padding; y++)
+            {
+                const int32_t frameY = std::clamp<int32_t>(y, 0, static_cast<int32_t>(placement.height) - 1);
+                const int32_t sourceY = std::min<int32_t>(source.y + frameY, image.height - 1);
+                const size_t rowStart = (static_cast<size_t>(placement.y + y) * packResult.pageWidth) * 4;
+
+                for (int32_t x = -padding; x < static_cast<int32_t>(placement.width) + padding; x++)
+                {
+                    const int32_t frameX = std::clamp<int32_t>(x, 0, static_cast<int32_t>(placement.width) - 1);
+                    const int32_t sourceX = std::min<int32_t>(source.x + frameX, image.width - 1);
+
+                    std::memcpy(
+                        &pixels[rowStart + static_cast<size_t>(placement.x + x) * 4],
+                        &image.data[(static_cast<size_t>(sourceY) * image.width + sourceX) * 4],
+                        4);
+                }
+            }
+        }
+    }
+
+    // Pages are only uploaded once a sprite or tile on them is drawn, the placeholder fills their slots until then
+    std::vector<uint32_t> pageSlots{};
+    pageSlots.reserve(pages.size());
+
+    for (size_t page = 0; page < pages.size(); page++)
+    {
+        const size_t managedTexture = m_textureResidency->addTexture(
+            packResult.pageWidth,
+            packResult.pageHeights[page],
+            std::move(pages[page]));
+
+        pageSlots.push_back(addTextureSlot(m_textureResidency->getImageView(managedTexture), nullptr, managedTexture));
+    }
+
+    std::vector<size_t> textureIndices{};
+    textureIndices.reserve(entries.size());
+
+    for (size_t entry = 0; entry < entries.size(); entry++)
+    {
+        m_textureFirstFrames.push_back(static_cast<uint32_t>(m_frameTable.size()));
+        textureIndices.push_back(m_textureFirstFrames.size() - 1);
+
+        for (const auto& placement : packResult.placements[entry])
+        {
+            const auto pageWidth = static_cast<float>(packResult.pageWidth);
+            const auto pageHeight = static_cast<float>(packResult.pageHeights[placement.page]);
+
+            FrameTableEntry frame{};
+            frame.rect =
+            {
+                .translateX = static_cast<float>(placement.x) / pageWidth,
+                .translateY = static_cast<float>(placement.y) / pageHeight,
+                .scaleX = static_cast<float>(placement.width) / pageWidth,
+                .scaleY = static_cast<float>(placement.height) / pageHeight
+            };
+            frame.textureIndex = pageSlots[placement.page];
+            m_frameTable.push_back(frame);
+        }
+
+        // Entries without frames still get one, like textures loaded on their own
+        if (packResult.placements[entry].empty())
+        {
+            FrameTableEntry frame{};
+            frame.rect = { .translateX = 0.0f, .translateY = 0.0f, .scaleX = 1.0f, .scaleY = 1.0f };
+            frame.textureIndex = pageSlots.empty() ? 0 : pageSlots[0];
+            m_frameTable.push_back(frame);
+        }
+    }
+
+    uploadFrameTable();
+    writeSceneDescriptorSets();
+
+    return textureIndices;
+}
+
+void VulkanRenderer::uploadFrameTable()
+{
+    // Frames only change when textures are loaded, so the table lives in device local memory and the old buffer
+    // is released through the deletion queue once frames in flight stop reading it
+    const VkDeviceSize frameTableSize = m_frameTable.size() * sizeof(FrameTableEntry);
+    m_frameTableBuffer = std::make_unique<Buffer>(
+        m_vulkanResources,
+        frameTableSize,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    m_frameTableBuffer->writeData(m_frameTable.data(), frameTableSize);
+}
+
+void VulkanRenderer::writeSceneDescriptorSets()
+{
+    for (size_t i = 0; i < m_framesInFlight; i++)
+    {
+        // Frames in flight may still have the old sets bound
         if (m_sceneDataDescriptorSets[i] != VK_NULL_HANDLE)
         {
-            vkFreeDescriptorSets(
-                m_vulkanResources->m_logicalDevice,
+            m_vulkanResources->m_deletionQueue->freeDescriptorSet(
                 m_vulkanResources->m_descriptorPool,
-                1,
-                &m_sceneDataDescriptorSets[i]);
+                m_sceneDataDescriptorSets[i]);
         }
     }
 
     m_sceneDataDescriptorSets.clear();
-    m_sceneDataDescriptorSets.resize(imageCount);
-    std::vector<VkDescriptorSetLayout> layouts(imageCount, m_vulkanResources->m_descriptorSetLayout);
+    m_sceneDataDescriptorSets.resize(m_framesInFlight);
+    std::vector<VkDescriptorSetLayout> layouts(m_framesInFlight, m_vulkanResources->m_descriptorSetLayout);
 
     VkDescriptorSetAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
     allocInfo.descriptorPool = m_vulkanResources->m_descriptorPool;
-    allocInfo.descriptorSetCount = imageCount;
+    allocInfo.descriptorSetCount = static_cast<uint32_t>(m_framesInFlight);
     allocInfo.pSetLayouts = layouts.data();
 
     const auto result = vkAllocateDescriptorSets(
@@ -181,53 +480,133 @@ size_t VulkanRenderer::loadTexture(const AtlasEntry& spriteInfo)
         throw std::runtime_error("failed to allocate descriptor sets!");
     }
 
-    std::vector<VkDescriptorImageInfo> imageInfos{m_textures.size()};
+    VkDescriptorBufferInfo frameTableInfo{};
+    frameTableInfo.buffer = m_frameTableBuffer->getBuffer();
+    frameTableInfo.offset = 0;
+    frameTableInfo.range = m_frameTableBuffer->getSize();
 
-    for (size_t i = 0; i < m_textures.size(); i++)
+    // The camera binding points into the upload ring and is written every frame in updateCamera
+    for (size_t i = 0; i < m_framesInFlight; i++)
     {
-        VkDescriptorImageInfo imageInfo{};
-        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        imageInfo.imageView = m_textures[i]->getImageView();
-        imageInfo.sampler = m_sampler;
+        const auto set = m_sceneDataDescriptorSets[i];
 
-        imageInfos[i] = imageInfo;
+        VkWriteDescriptorSet descriptorWrite{};
+        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrite.dstSet = set;
+        descriptorWrite.dstBinding = 2;
+        descriptorWrite.dstArrayElement = 0;
+        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptorWrite.descriptorCount = 1;
+        descriptorWrite.pBufferInfo = &frameTableInfo;
+
+        vkUpdateDescriptorSets(m_vulkanResources->m_logicalDevice, 1, &descriptorWrite, 0, nullptr);
     }
+}
 
-    for (size_t i = 0; i < imageCount; i++)
+uint32_t VulkanRenderer::addTextureSlot(
+    VkImageView imageView,
+    std::unique_ptr<Texture2D> texture,
+    size_t managedTexture)
+{
+    const uint32_t slot = m_vulkanResources->m_textureTable->add(imageView, m_sampler);
+
+    if (slot >= m_textures.size())
     {
-        const auto set = m_sceneDataDescriptorSets[i];
+        m_textures.resize(slot + 1);
+        m_managedTextures.resize(slot + 1, UNMANAGED_TEXTURE);
+    }
 
-        VkDescriptorBufferInfo bufferInfo{};
-        bufferInfo.buffer = m_cameraBuffers[i]->getBuffer();
-        bufferInfo.offset = 0;
-        bufferInfo.range = sizeof(CameraUniformData);
-
-        std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
-        descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrites[0].dstSet = set;
-        descriptorWrites[0].dstBinding = 0;
-        descriptorWrites[0].dstArrayElement = 0;
-        descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        descriptorWrites[0].descriptorCount = 1;
-        descriptorWrites[0].pBufferInfo = &bufferInfo;
-
-        descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrites[1].dstSet = set;
-        descriptorWrites[1].dstBinding = 1;
-        descriptorWrites[1].dstArrayElement = 0;
-        descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        descriptorWrites[1].descriptorCount = imageInfos.size();
-        descriptorWrites[1].pImageInfo = imageInfos.data();
-
-        vkUpdateDescriptorSets(
-            m_vulkanResources->m_logicalDevice,
-            static_cast<uint32_t>(descriptorWrites.size()),
-            descriptorWrites.data(),
-            0,
-            nullptr);
+    m_textures[slot] = std::move(texture);
+    m_managedTextures[slot] = managedTexture;
+
+    if (managedTexture != UNMANAGED_TEXTURE)
+    {
+        m_managedTextureSlots.resize(std::max(m_managedTextureSlots.size(), managedTexture + 1));
+        m_managedTextureSlots[managedTexture] = slot;
+    }
+
+    return slot;
+}
+
+void VulkanRenderer::invalidateTilemapChunks(const std::vector<size_t>& changedTextures)
+{
+    if (!m_chunkCache)
+    {
+        return;
+    }
+
+    // Chunks keep whatever the map's textures showed when they were rendered, the placeholder included
+    for (const uint32_t slot : m_tilemapTextureSlots)
+    {
+        if (std::ranges::find(changedTextures, m_managedTextures[slot]) != changedTextures.end())
+        {
+            m_chunkCache->invalidateAll();
+            return;
+        }
+    }
+}
+
+void VulkanRenderer::moveChangedTextures(const std::vector<size_t>& changedTextures)
+{
+    // Frames in flight still sample the old slots, so changed textures move to fresh slots instead of rewriting them.
+    // The old slots are reused once those frames have finished
+    std::vector<uint32_t> movedSlots(m_textures.size());
+    std::iota(movedSlots.begin(), movedSlots.end(), 0);
+
+    for (const size_t managedTexture : changedTextures)
+    {
+        const uint32_t oldSlot = m_managedTextureSlots[managedTexture];
+        const VkImageView imageView = m_textureResidency->getImageView(managedTexture);
+        const uint32_t newSlot = addTextureSlot(imageView, nullptr, managedTexture);
+
+        m_managedTextures[oldSlot] = UNMANAGED_TEXTURE;
+        m_vulkanResources->m_textureTable->remove(oldSlot);
+        movedSlots[oldSlot] = newSlot;
+    }
+
+    for (auto& frame : m_frameTable)
+    {
+        frame.textureIndex = movedSlots[frame.textureIndex];
+    }
+
+    for (auto& slot : m_tilemapTextureSlots)
+    {
+        slot = movedSlots[slot];
+    }
+
+    // Written in place on the GPU, after the frames in flight finished reading the old entries. The frame table may
+    // be host visible, so the write is queued directly instead of through writeData
+    m_vulkanResources->m_bufferUploadQueue->write(
+        m_frameTableBuffer->getBuffer(),
+        0,
+        m_frameTable.data(),
+        m_frameTable.size() * sizeof(FrameTableEntry));
+
+    invalidateTilemapChunks(changedTextures);
+}
+
+void VulkanRenderer::collectTilemapTextureSlots()
+{
+    // The map is drawn every frame, so the textures of all its tiles are referenced every frame
+    std::vector<bool> usedSlots(m_textures.size(), false);
+
+    for (const uint32_t tileId : m_tilemapRenderer->getTileIds())
+    {
+        if (tileId != 0)
+        {
+            usedSlots[m_frameTable[tileId - 1].textureIndex] = true;
+        }
     }
 
-    return m_textures.size() - 1;
+    m_tilemapTextureSlots.clear();
+
+    for (uint32_t slot = 0; slot < usedSlots.size(); slot++)
+    {
+        if (usedSlots[slot])
+        {
+            m_tilemapTextureSlots.push_back(slot);
+        }
+    }
 }
 
 void VulkanRenderer::onMeshCreated(const Mesh& mesh)
@@ -293,121 +672,307 @@ void VulkanRenderer::initializeSampler()
     }
 }
 
-void VulkanRenderer::updateCamera(const Camera& camera, size_t imageIndex)
+void VulkanRenderer::updateCamera(const Camera& camera, size_t frameIndex)
 {
     const auto constants = CameraUniformData
     {
         camera.getViewProjectionMatrix()
     };
 
-    m_cameraBuffers[imageIndex]->writeData(&constants, sizeof(CameraUniformData));
+    const auto set = m_sceneDataDescriptorSets[frameIndex];
+
+    if (set == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    const auto allocation = m_uploadRing->upload(
+        &constants,
+        sizeof(CameraUniformData),
+        m_vulkanResources->m_physicalDeviceProperties.limits.minUniformBufferOffsetAlignment);
+
+    VkDescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = allocation.buffer;
+    bufferInfo.offset = allocation.offset;
+    bufferInfo.range = sizeof(CameraUniformData);
+
+    VkWriteDescriptorSet descriptorWrite{};
+    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrite.dstSet = set;
+    descriptorWrite.dstBinding = 0;
+    descriptorWrite.dstArrayElement = 0;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pBufferInfo = &bufferInfo;
+
+    vkUpdateDescriptorSets(m_vulkanResources->m_logicalDevice, 1, &descriptorWrite, 0, nullptr);
 }
 
-void VulkanRenderer::updateObjectBuffers(
-    VkCommandBuffer commandBuffer,
-    size_t imageIndex)
+void VulkanRenderer::updateInstanceIndices()
 {
-    m_instanceIndices.clear();
+    m_instanceIndicesScratch.clear();
 
-    for (auto& drawRequest : m_drawRequests)
+    for (const uint64_t drawKey : m_drawKeys)
     {
-        m_instanceIndices.push_back(drawRequest.instanceIndex);
+        m_instanceIndicesScratch.push_back(static_cast<uint32_t>(DrawKey::getInstanceIndex(drawKey)));
     }
 
-    m_instanceIndexBuffers[imageIndex]->writeData(m_instanceIndices.data(), sizeof(uint32_t) * m_drawRequests.size());
+    // Storage buffer ranges must not be empty, so there is always at least one index
+    if (m_instanceIndicesScratch.empty())
+    {
+        m_instanceIndicesScratch.push_back(0);
+    }
 
-    for (const auto& data : m_objectBuffers)
+    // With culling on the GPU the candidates only change when objects move or appear, not when the camera moves
+    if (m_instanceIndexBuffer && m_instanceIndicesScratch == m_instanceIndices)
     {
-        data->updateGpuBuffer(commandBuffer, m_vulkanResources->m_graphicsQueue, imageIndex);
-        vkQueueWaitIdle(m_vulkanResources->m_graphicsQueue);
+        return;
     }
+
+    std::swap(m_instanceIndices, m_instanceIndicesScratch);
+    const VkDeviceSize size = sizeof(uint32_t) * m_instanceIndices.size();
+
+    if (!m_instanceIndexBuffer || m_instanceIndexBuffer->getSize() < size)
+    {
+        // Frames in flight keep the old buffer, the deletion queue releases it once they have finished
+        const VkDeviceSize capacity = m_instanceIndexBuffer ? m_instanceIndexBuffer->getSize() * 2 : size;
+
+        m_instanceIndexBuffer = std::make_unique<Buffer>(
+            m_vulkanResources,
+            std::max(size, capacity),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    }
+
+    // Written in place on the GPU once the frames in flight stopped reading the previous indices
+    m_vulkanResources->m_bufferUploadQueue->write(
+        m_instanceIndexBuffer->getBuffer(),
+        0,
+        m_instanceIndices.data(),
+        size);
 }
 
-void VulkanRenderer::drawScene(
-    const Camera& camera,
-    const std::vector<DrawRequest>& drawRequests,
-    ImDrawData* uiData)
+void VulkanRenderer::updateObjectBuffers(
+    VkCommandBuffer commandBuffer,
+    size_t frameIndex)
 {
-    m_drawRequests = drawRequests; // Copy
+    PROFILE_SCOPE("Uploads");
+    m_uploadBarriers.clear();
+    updateInstanceIndices();
 
-    std::ranges::stable_sort(m_drawRequests, [](const auto& a, const auto& b) {
-        if (a.layer != b.layer)
-        {
-            return a.layer < b.layer;
-        }
+    const uint32_t uploadScope = m_gpuProfiler->beginScope(commandBuffer, "Uploads");
+
+    // Writes to device local buffers since the last frame, like the frame table and the tiles of the map
+    m_vulkanResources->m_bufferUploadQueue->record(commandBuffer, *m_uploadRing, m_uploadBarriers);
 
-        if (a.orderInLayer != b.orderInLayer)
+    for (const auto& data : m_objectBuffers)
+    {
+        data->recordUpload(commandBuffer, frameIndex, *m_uploadRing, m_uploadBarriers);
+    }
+
+    // The camera lives in the scene set, which only exists once textures are loaded
+    m_cullingActive =
+        m_cullingPass &&
+        m_gpuCullingEnabled &&
+        !m_drawBatches.empty() &&
+        m_sceneDataDescriptorSets[frameIndex] != VK_NULL_HANDLE;
+
+    if (!m_uploadBarriers.empty())
+    {
+        VkPipelineStageFlags dstStages =
+            VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+            VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+        if (m_cullingActive)
         {
-            return a.orderInLayer < b.orderInLayer;
+            dstStages |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
         }
 
-        return false;
-    });
-
-    auto swapchain = m_vulkanResources->getSwapchain().lock();
-    const auto currentFrameElement = swapchain->getCurrentFrame();
+        // One barrier for all uploads of this frame, the shaders only read the buffers after all copies are done
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            dstStages,
+            0,
+            0,
+            nullptr,
+            static_cast<uint32_t>(m_uploadBarriers.size()),
+            m_uploadBarriers.data(),
+            0,
+            nullptr);
+    }
 
-    vkWaitForFences(m_vulkanResources->m_logicalDevice, 1, &currentFrameElement->fence, VK_TRUE, UINT64_MAX);
+    m_gpuProfiler->endScope(commandBuffer, uploadScope);
 
-    uint32_t imageIndex;
-    VkResult result = vkAcquireNextImageKHR(
-        m_vulkanResources->m_logicalDevice,
-        swapchain->m_swapchain,
-        UINT64_MAX,
-        currentFrameElement->startSemaphore,
-        VK_NULL_HANDLE,
-        &imageIndex);
+    VkDescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = m_instanceIndexBuffer->getBuffer();
+    bufferInfo.offset = 0;
+    bufferInfo.range = sizeof(uint32_t) * m_instanceIndices.size();
 
-    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
+    if (m_cullingActive)
     {
-        swapchain.reset();
-        m_vulkanResources->recreateSwapchain();
-        return;
+        m_cullBatches.clear();
+
+        for (const auto& batch : m_drawBatches)
+        {
+            const auto& pipeline = *m_pipelines[batch.pipelineIndex];
+
+            m_cullBatches.push_back(
+            {
+                static_cast<uint32_t>(batch.firstKey),
+                static_cast<uint32_t>(batch.lastKey - batch.firstKey + 1),
+                m_objectBuffers[pipeline.getDataBufferIndex()]->getDescriptorSet(frameIndex),
+                pipeline.isGpuCulled()
+            });
+        }
+
+        const uint32_t cullingScope = m_gpuProfiler->beginScope(commandBuffer, "Culling");
+        m_cullingPass->record(
+            commandBuffer,
+            frameIndex,
+            m_sceneDataDescriptorSets[frameIndex],
+            bufferInfo,
+            m_cullBatches,
+            static_cast<uint32_t>(m_meshes[0]->getIndices().size()));
+        m_gpuProfiler->endScope(commandBuffer, cullingScope);
+
+        // The vertex shaders read the compacted indices instead of all candidates
+        bufferInfo.buffer = m_cullingPass->getVisibleIndexBuffer(frameIndex);
+        bufferInfo.offset = 0;
+        bufferInfo.range = VK_WHOLE_SIZE;
     }
 
-    if (result != VK_SUCCESS)
+    VkWriteDescriptorSet descriptorWrite{};
+    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrite.dstSet = m_frameDataDescriptorSets[frameIndex];
+    descriptorWrite.dstBinding = 0;
+    descriptorWrite.dstArrayElement = 0;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pBufferInfo = &bufferInfo;
+
+    vkUpdateDescriptorSets(m_vulkanResources->m_logicalDevice, 1, &descriptorWrite, 0, nullptr);
+}
+
+void VulkanRenderer::drawScene(
+    const Camera& camera,
+    std::span<const DrawRequest> drawRequests,
+    ImDrawData* uiData)
+{
+    createPipelines();
     {
-        throw std::runtime_error("failed to acquire swap chain image!");
+        PROFILE_SCOPE("Sort");
+        m_drawKeys.clear();
+
+        for (const auto& drawRequest : drawRequests)
+        {
+            m_drawKeys.push_back(DrawKey::pack(drawRequest));
+        }
+
+        DrawKey::sort(m_drawKeys, m_drawKeysScratch);
+        DrawKey::buildBatches(m_drawKeys, m_drawBatches);
     }
 
-    const auto currentImageElement = swapchain->getFrameAt(imageIndex);
+    auto swapchain = m_vulkanResources->getSwapchain().lock();
+    FrameRing& frameRing = *m_vulkanResources->m_frameRing;
+
+    // Only waits for the submission that last used this slot, the GPU may still execute the previous frame
+    const FrameContext& frame = frameRing.beginFrame();
+    const size_t frameIndex = frameRing.getFrameIndex();
+    const VkCommandBuffer commandBuffer = frame.commandBuffer;
+    m_vulkanResources->m_deletionQueue->beginFrame();
+
+    OffscreenTarget* offscreenTarget = m_vulkanResources->getOffscreenTarget();
+    const VkExtent2D extent = m_vulkanResources->getRenderExtent();
+    const SwapchainElement* currentImageElement = nullptr;
+    uint32_t imageIndex = 0;
 
-    if (currentImageElement->lastFence)
+    // Headless frames render into the offscreen image of their slot, there is nothing to acquire
+    if (!offscreenTarget)
     {
-        const VkResult fenceResult = vkWaitForFences(
+        const VkResult result = vkAcquireNextImageKHR(
             m_vulkanResources->m_logicalDevice,
-            1,
-            &currentImageElement->lastFence,
-            true,
-            UINT64_MAX);
+            swapchain->m_swapchain,
+            UINT64_MAX,
+            frame.acquireSemaphore,
+            VK_NULL_HANDLE,
+            &imageIndex);
+
+        // A suboptimal swapchain still signals the acquire semaphore, so the frame is drawn and it is recreated
+        // after the present
+        if (result == VK_ERROR_OUT_OF_DATE_KHR)
+        {
+            swapchain.reset();
+            m_vulkanResources->recreateSwapchain();
+            return;
+        }
 
-        if (fenceResult != VK_SUCCESS)
+        if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
         {
-            throw std::runtime_error("failed to wait for last element fence");
+            throw std::runtime_error("failed to acquire swap chain image!");
         }
+
+        currentImageElement = swapchain->getFrameAt(imageIndex);
     }
 
-    currentImageElement->lastFence = currentFrameElement->fence;
+    const VkImage targetImage = offscreenTarget ? offscreenTarget->getImage(frameIndex) : currentImageElement->image;
+    const VkImageView targetImageView = offscreenTarget
+        ? offscreenTarget->getImageView(frameIndex)
+        : currentImageElement->imageView;
 
-    vkResetFences(m_vulkanResources->m_logicalDevice, 1, &(currentFrameElement->fence));
-    vkResetCommandBuffer(currentImageElement->commandBuffer, 0);
+    for (const uint32_t textureSlot : m_tilemapTextureSlots)
+    {
+        referenceTextureSlot(textureSlot);
+    }
 
-    updateCamera(camera, imageIndex);
-    updateObjectBuffers(currentImageElement->commandBuffer, imageIndex);
+    // The last submission of this frame slot is done, its upload ranges and descriptor sets can be reused
+    m_uploadRing->beginFrame(frameIndex);
 
     VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
     beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
-    if (vkBeginCommandBuffer(currentImageElement->commandBuffer, &beginInfo) != VK_SUCCESS)
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
     {
         throw std::runtime_error("failed to begin recording command buffer!");
     }
 
-    imageToAttachmentLayout(currentImageElement);
+    m_gpuProfiler->beginFrame(commandBuffer, frameIndex);
+
+    // Recorded ahead of the frame's draws, which are the first commands allowed to sample the new images
+    if (m_textureResidency->update(commandBuffer, *m_uploadRing))
+    {
+        moveChangedTextures(m_textureResidency->getChangedTextures());
+    }
+
+    updateCamera(camera, frameIndex);
+    updateObjectBuffers(commandBuffer, frameIndex);
+
+    // Vertex and index buffer bindings outlive render passes, the chunk cache renders its chunks before the frame's
+    const Mesh& mesh = *m_meshes[0];
+    const size_t meshIndex = mesh.getMeshIndex();
+    const auto indexCount = static_cast<uint32_t>(mesh.getIndices().size());
+
+    VkBuffer vertexBuffers[] = { m_vertexBuffers[meshIndex]->getBuffer() };
+    VkDeviceSize offsets[] = { 0 };
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+    vkCmdBindIndexBuffer(commandBuffer, m_indexBuffers[meshIndex]->getBuffer(), 0, VK_INDEX_TYPE_UINT16);
+
+    const uint32_t chunkScope = m_gpuProfiler->beginScope(commandBuffer, "Chunk rendering");
+    m_chunkCacheActive = m_chunkCacheEnabled && m_chunkCache->prepare(
+        commandBuffer,
+        camera.getFrustum(),
+        m_pixelsPerUnit,
+        *m_tilemapRenderer,
+        m_sceneDataDescriptorSets[frameIndex],
+        indexCount);
+    m_gpuProfiler->endScope(commandBuffer, chunkScope);
+
+    imageToAttachmentLayout(commandBuffer, targetImage);
 
     VkRenderingAttachmentInfo colorAttachment{};
     colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
-    colorAttachment.imageView = currentImageElement->imageView;
+    colorAttachment.imageView = targetImageView;
     colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
     colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
     colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
@@ -417,108 +982,114 @@ void VulkanRenderer::drawScene(
     renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
     renderingInfo.renderArea = {
         { 0, 0 },
-        { swapchain->m_width, swapchain->m_height }
+        { extent.width, extent.height }
     };
     renderingInfo.layerCount = 1;
     renderingInfo.colorAttachmentCount = 1;
     renderingInfo.pColorAttachments = &colorAttachment;
 
-    vkCmdBeginRendering(currentImageElement->commandBuffer, &renderingInfo);
+    vkCmdBeginRendering(commandBuffer, &renderingInfo);
 
     // Set render size
     VkViewport viewport = {
         0,
         0,
-        static_cast<float>(swapchain->m_width),
-        static_cast<float>(swapchain->m_height),
+        static_cast<float>(extent.width),
+        static_cast<float>(extent.height),
         0,
         1
     };
-    vkCmdSetViewport(currentImageElement->commandBuffer, 0, 1, &viewport);
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 
     VkRect2D scissor = {
         { 0, 0 },
-        { swapchain->m_width, swapchain->m_height }
+        { extent.width, extent.height }
     };
-    vkCmdSetScissor(currentImageElement->commandBuffer, 0, 1, &scissor);
-
-    const auto currentFrameIndex = swapchain->getCurrentFrameIndex();
-
-    const Mesh& mesh = *m_meshes[0];
-    const size_t meshIndex = mesh.getMeshIndex();
-
-    VkBuffer vertexBuffers[] = { m_vertexBuffers[meshIndex]->getBuffer() };
-    VkDeviceSize offsets[] = { 0 };
-    vkCmdBindVertexBuffers(currentImageElement->commandBuffer, 0, 1, vertexBuffers, offsets);
-    vkCmdBindIndexBuffer(currentImageElement->commandBuffer, m_indexBuffers[meshIndex]->getBuffer(), 0, VK_INDEX_TYPE_UINT16);
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 
-    size_t batchStartIndex = 0;
-    size_t batchEndIndex = 0;
+    const uint32_t tilemapScope = m_gpuProfiler->beginScope(commandBuffer, "Tilemap");
 
-    // Big loop over all objects to make sure everything gets drawn.
-    while (
-        batchStartIndex < m_drawRequests.size() &&
-        batchEndIndex < m_drawRequests.size())
+    if (m_chunkCacheActive)
     {
-        const auto& currentBatchStartElement = m_drawRequests[batchStartIndex];
-
-        // Small loop to find the elements for the next draw batch
-        while (
-            batchEndIndex < m_drawRequests.size() - 1 &&
-            m_drawRequests[batchEndIndex + 1].layer == currentBatchStartElement.layer &&
-            m_drawRequests[batchEndIndex + 1].pipelineIndex == currentBatchStartElement.pipelineIndex)
-        {
-            batchEndIndex += 1;
-        }
+        m_chunkCache->record(commandBuffer, camera.getViewProjectionMatrix(), indexCount);
+    }
+    else
+    {
+        m_tilemapRenderer->record(
+            commandBuffer,
+            m_sceneDataDescriptorSets[frameIndex],
+            indexCount,
+            camera.getViewProjectionMatrix());
+    }
 
-        drawIndexed(
-            currentImageElement,
-            currentFrameIndex,
-            currentBatchStartElement.pipelineIndex,
-            batchStartIndex,
-            batchEndIndex);
+    m_gpuProfiler->endScope(commandBuffer, tilemapScope);
 
-        batchStartIndex = batchEndIndex + 1;
-        batchEndIndex = batchEndIndex + 1;
+    for (size_t i = 0; i < m_drawBatches.size(); i++)
+    {
+        // Scopes of batches are told apart by their pipeline, so sprites, circles and rectangles can be compared
+        const uint32_t batchScope = m_gpuProfiler->beginScope(
+            commandBuffer,
+            "Batch of pipeline",
+            static_cast<uint32_t>(m_drawBatches[i].pipelineIndex));
+        drawIndexed(commandBuffer, frameIndex, i);
+        m_gpuProfiler->endScope(commandBuffer, batchScope);
     }
 
     if (uiData)
     {
-        ImGui_ImplVulkan_RenderDrawData(uiData, currentImageElement->commandBuffer);
+        const uint32_t uiScope = m_gpuProfiler->beginScope(commandBuffer, "UI");
+        ImGui_ImplVulkan_RenderDrawData(uiData, commandBuffer);
+        m_gpuProfiler->endScope(commandBuffer, uiScope);
     }
 
-    vkCmdEndRendering(currentImageElement->commandBuffer);
+    vkCmdEndRendering(commandBuffer);
 
-    imageToPresentLayout(currentImageElement);
+    if (offscreenTarget)
+    {
+        imageToFinalLayout(commandBuffer, targetImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
 
-    if(vkEndCommandBuffer(currentImageElement->commandBuffer) != VK_SUCCESS)
+        if (m_readbackEnabled)
+        {
+            offscreenTarget->recordReadback(commandBuffer, frameIndex);
+        }
+    }
+    else
     {
-        throw std::runtime_error("failed to record command buffer!");
+        imageToFinalLayout(commandBuffer, targetImage, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
     }
 
-    VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    if(vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to record command buffer!");
+    }
 
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = &currentFrameElement->startSemaphore;
-    submitInfo.pWaitDstStageMask = &waitStage;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &currentImageElement->commandBuffer;
-    submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores = &currentFrameElement->endSemaphore;
+    if (offscreenTarget)
+    {
+        PROFILE_SCOPE("Submit");
+        frameRing.submit(m_vulkanResources->m_graphicsQueue, VK_NULL_HANDLE, VK_NULL_HANDLE);
+        m_lastReadbackFrame = m_readbackEnabled ? static_cast<int64_t>(frameIndex) : -1;
+        return;
+    }
 
-    if(vkQueueSubmit(m_vulkanResources->m_graphicsQueue, 1, &submitInfo, currentFrameElement->fence)) {}
+    {
+        PROFILE_SCOPE("Submit");
+        frameRing.submit(m_vulkanResources->m_graphicsQueue, frame.acquireSemaphore, currentImageElement->endSemaphore);
+    }
 
     VkPresentInfoKHR presentInfo{};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
     presentInfo.waitSemaphoreCount = 1;
-    presentInfo.pWaitSemaphores = &currentFrameElement->endSemaphore;
+    presentInfo.pWaitSemaphores = &currentImageElement->endSemaphore;
     presentInfo.swapchainCount = 1;
     presentInfo.pSwapchains = &swapchain->m_swapchain;
     presentInfo.pImageIndices = &imageIndex;
 
-    result = vkQueuePresentKHR(m_vulkanResources->m_graphicsQueue, &presentInfo);
+    VkResult result;
+
+    {
+        PROFILE_SCOPE("Present");
+        result = vkQueuePresentKHR(m_vulkanResources->m_graphicsQueue, &presentInfo);
+    }
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
     {
@@ -531,11 +1102,28 @@ void VulkanRenderer::drawScene(
     {
         throw std::runtime_error("failed to present image!");
     }
+}
+
+ReadbackImage VulkanRenderer::readbackLastFrame() const
+{
+    const OffscreenTarget* offscreenTarget = m_vulkanResources->getOffscreenTarget();
+
+    if (!offscreenTarget || m_lastReadbackFrame < 0)
+    {
+        throw std::runtime_error("the last frame was not read back, readback needs a headless renderer");
+    }
 
-    swapchain->moveToNextFrame();
+    vkQueueWaitIdle(m_vulkanResources->m_graphicsQueue);
+
+    return offscreenTarget->readPixels(static_cast<size_t>(m_lastReadbackFrame));
 }
 
-void VulkanRenderer::imageToAttachmentLayout(SwapchainElement *element)
+void VulkanRenderer::saveLastFrame(const std::filesystem::path& filePath) const
+{
+    PngWriter::write(filePath, readbackLastFrame());
+}
+
+void VulkanRenderer::imageToAttachmentLayout(VkCommandBuffer commandBuffer, VkImage image)
 {
     VkImageMemoryBarrier beforeBarrier{};
     beforeBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -543,13 +1131,13 @@ void VulkanRenderer::imageToAttachmentLayout(SwapchainElement *element)
     beforeBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
     beforeBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
     beforeBarrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-    beforeBarrier.image = element->image;
+    beforeBarrier.image = image;
     beforeBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     beforeBarrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
     beforeBarrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
 
     vkCmdPipelineBarrier(
-        element->commandBuffer,
+        commandBuffer,
         VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
         VK_PIPELINE_STAGE_TRANSFER_BIT,
         0,
@@ -562,23 +1150,26 @@ void VulkanRenderer::imageToAttachmentLayout(SwapchainElement *element)
     );
 }
 
-void VulkanRenderer::imageToPresentLayout(SwapchainElement *element)
+void VulkanRenderer::imageToFinalLayout(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout layout)
 {
+    // Presenting needs no further dependency, a readback copy has to wait for the color writes
+    const bool transferSource = layout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
     VkImageMemoryBarrier afterBarrier{};
     afterBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    afterBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    afterBarrier.dstAccessMask = VK_ACCESS_NONE;
+    afterBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    afterBarrier.dstAccessMask = transferSource ? VK_ACCESS_TRANSFER_READ_BIT : VK_ACCESS_NONE;
     afterBarrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-    afterBarrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-    afterBarrier.image = element->image;
+    afterBarrier.newLayout = layout;
+    afterBarrier.image = image;
     afterBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     afterBarrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
     afterBarrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
 
     vkCmdPipelineBarrier(
-        element->commandBuffer,
-        VK_PIPELINE_STAGE_TRANSFER_BIT,
-        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        commandBuffer,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        transferSource ? VK_PIPELINE_STAGE_TRANSFER_BIT : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
         0,
         0,
         nullptr,
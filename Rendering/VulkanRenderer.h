@@ -5,16 +5,27 @@
 
 #include "vulkan/vulkan.h"
 #include <GLFW/glfw3.h>
+#include <span>
 #include <vector>
 #include <unordered_map>
 
+#include "AssetManager.h"
 #include "Buffer.h"
 #include "Circle.h"
+#include "ChunkCache.h"
+#include "CullingPass.h"
+#include "DrawKey.h"
 #include "DrawRequest.h"
+#include "GpuProfiler.h"
+#include "IRenderer.h"
 #include "ObjectBuffer.h"
 #include "Pipeline.h"
+#include "SpriteRenderData.h"
 #include "Swapchain.h"
 #include "Texture2D.h"
+#include "TextureResidency.h"
+#include "TilemapRenderer.h"
+#include "UploadRing.h"
 #include "VulkanResources.h"
 #include "../Core/Camera.h"
 #include "../Core/Mesh.h"
@@ -24,77 +35,178 @@
 
 struct SpriteRenderData;
 
-class VulkanRenderer
+typedef struct
+{
+    size_t pipelineIndex;
+    std::filesystem::path vertexShaderPath;
+    std::filesystem::path fragmentShaderPath;
+    size_t dataBufferIndex;
+    bool gpuCulled;
+} PendingPipeline;
+
+class VulkanRenderer : public IRenderer
 {
 public:
     VulkanRenderer(
         std::filesystem::path assetsBasePath,
         std::shared_ptr<VulkanResources> resources,
         uint32_t pixelsPerUnit);
-    ~VulkanRenderer();
+    ~VulkanRenderer() override;
 
     void initialize();
     size_t loadTexture(const AtlasEntry& spriteInfo);
 
-    void drawScene(
-        const Camera& camera,
-        const std::vector<DrawRequest>& drawRequests,
-        ImDrawData* uiData);
+    /**
+     * Loads one texture per entry with a single upload submission and a single descriptor update for all of them.
+     * Returns the texture index of every entry, for getFrameIndex.
+     */
+    std::vector<size_t> loadTextures(std::span<const AtlasEntry> spriteInfos);
 
-    [[nodiscard]] uint32_t getPixelsPerUnit() const { return m_pixelsPerUnit; }
-    void setPixelsPerUnit(uint32_t pixelsPerUnit) { m_pixelsPerUnit = pixelsPerUnit; }
+    /**
+     * Packs the frames of all atlas entries into as few texture pages as possible instead of one texture per entry.
+     * Returns the texture index of every entry, for getFrameIndex, in the order of the entries.
+     */
+    std::vector<size_t> loadAtlas(const LoadedAtlas& atlas) override;
 
-    [[nodiscard]] const Texture2D& getTexture(size_t index) const
+    /**
+     * Index into the frame table that the sprite shader reads the UV rect and texture of an instance from.
+     * Counts as a use of the frame's texture in this frame, which makes it resident.
+     */
+    [[nodiscard]] uint32_t getFrameIndex(size_t textureIndex, size_t frame) override
     {
-        return *m_textures[index];
+        const uint32_t frameIndex = m_textureFirstFrames[textureIndex] + static_cast<uint32_t>(frame);
+        referenceTextureSlot(m_frameTable[frameIndex].textureIndex);
+
+        return frameIndex;
     }
 
-    template<typename T>
-    size_t registerDataType(size_t initialSize)
+    /**
+     * The map is drawn below all draw requests. Only uploads when the map changed since the last call.
+     */
+    void updateTilemap(const Map& map) override
     {
-        m_objectBuffers.emplace_back(
-            std::make_unique<ObjectBuffer<T>>(
-                m_vulkanResources,
-                m_imageCount,
-                initialSize));
-        return m_objectBuffers.size() - 1;
+        if (m_tilemapRenderer->update(map, m_textureFirstFrames))
+        {
+            m_chunkCache->invalidate(*m_tilemapRenderer);
+
+            collectTilemapTextureSlots();
+        }
     }
 
-    template<typename T>
-    ObjectBuffer<T>& getDataBuffer(size_t index)
+    /**
+     * Atlas pages are uploaded when first drawn and evicted least recently drawn first over this budget.
+     */
+    void setTextureBudget(VkDeviceSize budgetBytes) { m_textureResidency->setBudget(budgetBytes); }
+    [[nodiscard]] const TextureResidencyStatistics& getTextureResidencyStatistics() const
     {
-        IGenericBuffer& reference = *m_objectBuffers[index];
-        return static_cast<ObjectBuffer<T>&>(reference);
+        return m_textureResidency->getStatistics();
     }
 
-    template<typename T>
-    const ObjectBuffer<T>& getDataBuffer(size_t index) const
+    /**
+     * Without the chunk cache every tile layer is resolved per pixel in every frame.
+     */
+    void setChunkCacheEnabled(bool enabled) { m_chunkCacheEnabled = enabled; }
+    [[nodiscard]] ChunkCacheStatistics getChunkCacheStatistics() const
     {
-        const IGenericBuffer& reference = *m_objectBuffers[index];
-        return static_cast<ObjectBuffer<T>&>(reference);
+        return m_chunkCache ? m_chunkCache->getStatistics() : ChunkCacheStatistics{};
     }
 
+    /**
+     * Draws drawRequests sorted by layer and order in layer. The requests are only read while building the sort keys,
+     * the caller keeps ownership of its list.
+     */
+    void drawScene(
+        const Camera& camera,
+        std::span<const DrawRequest> drawRequests,
+        ImDrawData* uiData) override;
+
+    [[nodiscard]] uint32_t getPixelsPerUnit() const { return m_pixelsPerUnit; }
+    void setPixelsPerUnit(uint32_t pixelsPerUnit) { m_pixelsPerUnit = pixelsPerUnit; }
+
+    /**
+     * Bytes staged for upload to the GPU by the last drawScene call.
+     */
+    [[nodiscard]] VkDeviceSize getUploadedBytes() const { return m_uploadRing->getFrameUploadedBytes(); }
+
+    /**
+     * Headless only. While enabled every frame copies its image to host memory, which benchmarks of the rendering
+     * alone should leave off.
+     */
+    void setReadbackEnabled(bool enabled) { m_readbackEnabled = enabled; }
+
+    /**
+     * Waits for the last frame and returns its pixels. Requires a headless renderer and readback to have been
+     * enabled when the last frame was drawn.
+     */
+    [[nodiscard]] ReadbackImage readbackLastFrame() const;
+
+    /**
+     * Writes the last frame to a PNG file, see readbackLastFrame.
+     */
+    void saveLastFrame(const std::filesystem::path& filePath) const;
+
+    /**
+     * Time the last frame waited for the GPU to finish the frame that used its slot before.
+     */
+    [[nodiscard]] double getFrameWaitMilliseconds() const
+    {
+        return m_vulkanResources->m_frameRing->getLastWaitMilliseconds();
+    }
+
+    /**
+     * Culls gpu culled pipelines in a compute pass and draws every batch indirectly. Only has an effect when the
+     * culling shader was found and the device supports drawIndirectFirstInstance.
+     */
+    void setGpuCullingEnabled(bool enabled) { m_gpuCullingEnabled = enabled; }
+    [[nodiscard]] bool isGpuCullingAvailable() const { return m_cullingPass != nullptr; }
+    [[nodiscard]] bool isGpuCullingActive() const override { return m_cullingPass && m_gpuCullingEnabled; }
+
+    /**
+     * Times uploads, culling, the tilemap, every batch and the UI on the GPU, see GpuProfiler. Has no effect when the
+     * graphics queue does not support timestamps.
+     */
+    void setGpuProfilingEnabled(bool enabled) { m_gpuProfiler->setEnabled(enabled && m_gpuProfiler->isAvailable()); }
+    [[nodiscard]] const GpuProfiler& getGpuProfiler() const { return *m_gpuProfiler; }
+
+    [[nodiscard]] const Texture2D& getTexture(size_t index) const
+    {
+        return *m_textures[index];
+    }
+
+    /**
+     * Only records the shaders, the pipeline is created by the next createPipelines. Returns the pipeline index.
+     */
     size_t registerShader(
         const std::filesystem::path& vertexShaderPath,
         const std::filesystem::path& fragmentShaderPath,
-        size_t dataBufferIndex)
+        size_t dataBufferIndex,
+        bool gpuCulled = false) override
     {
-        const Shader spriteShader(
-            m_vulkanResources->m_logicalDevice,
+        m_pendingPipelines.push_back({
+            m_pipelines.size(),
             vertexShaderPath,
-            fragmentShaderPath);
-
-        m_pipelines.emplace_back(
-            std::make_unique<Pipeline>(
-                m_vulkanResources,
-                spriteShader,
-                m_vulkanResources->getSwapchain().lock()->m_format.format,
-                dataBufferIndex));
+            fragmentShaderPath,
+            dataBufferIndex,
+            gpuCulled
+        });
+        m_pipelines.emplace_back(nullptr);
 
         return m_pipelines.size() - 1;
     }
 
+    /**
+     * Creates the pipelines of all shaders registered since the last call in parallel, each worker thread loads its
+     * shader modules and compiles with the shared pipeline cache. Called by drawScene for pipelines that are left.
+     */
+    void createPipelines() override;
+
 private:
+    static constexpr VkDeviceSize UPLOAD_RING_SIZE = 32 * 1024 * 1024;
+    static constexpr size_t INITIAL_DRAW_CAPACITY = 10000;
+    static constexpr uint32_t ATLAS_PAGE_SIZE = 2048;
+    static constexpr uint32_t ATLAS_PADDING = 1;
+    static constexpr size_t UNMANAGED_TEXTURE = SIZE_MAX;
+
     uint32_t m_pixelsPerUnit = 1;
     std::filesystem::path m_assetsBasePath;
     std::vector<VkDescriptorSet> m_sceneDataDescriptorSets;
@@ -102,55 +214,101 @@ private:
 
     std::shared_ptr<VulkanResources> m_vulkanResources;
     std::vector<std::unique_ptr<Pipeline>> m_pipelines {};
+    std::vector<PendingPipeline> m_pendingPipelines{};
 
     std::vector<std::unique_ptr<Mesh>> m_meshes;
+    // Indexed by slot in the bindless texture table, null for slots whose texture is managed by the residency
     std::vector<std::unique_ptr<Texture2D>> m_textures;
+    std::vector<size_t> m_managedTextures{};
+    std::vector<uint32_t> m_managedTextureSlots{};
+    std::unique_ptr<TextureResidency> m_textureResidency;
+    std::vector<uint32_t> m_tilemapTextureSlots{};
+    std::vector<FrameTableEntry> m_frameTable{};
+    std::vector<uint32_t> m_textureFirstFrames{};
+    std::unique_ptr<Buffer> m_frameTableBuffer;
+    std::unique_ptr<Buffer> m_instanceIndexBuffer;
 
     std::vector<std::unique_ptr<Buffer>> m_vertexBuffers{1};
     std::vector<std::unique_ptr<Buffer>> m_indexBuffers{1};
-    std::vector<std::unique_ptr<Buffer>> m_cameraBuffers{};
-    std::vector<std::unique_ptr<Buffer>> m_instanceIndexBuffers{};
+    std::unique_ptr<UploadRing> m_uploadRing;
+    std::unique_ptr<CullingPass> m_cullingPass;
+    std::unique_ptr<TilemapRenderer> m_tilemapRenderer;
+    std::unique_ptr<ChunkCache> m_chunkCache;
+    std::unique_ptr<GpuProfiler> m_gpuProfiler;
+    bool m_chunkCacheEnabled = true;
+    bool m_chunkCacheActive = false;
+    bool m_gpuCullingEnabled = true;
+    bool m_cullingActive = false;
 
-    std::vector<std::unique_ptr<IGenericBuffer>> m_objectBuffers{};
-    std::vector<DrawRequest> m_drawRequests{};
-    std::vector<uint32_t> m_instanceIndices{10000};
+    std::vector<uint64_t> m_drawKeys{};
+    std::vector<uint64_t> m_drawKeysScratch{};
+    std::vector<DrawBatch> m_drawBatches{};
+    std::vector<CullBatch> m_cullBatches{};
+    std::vector<uint32_t> m_instanceIndices{};
+    std::vector<uint32_t> m_instanceIndicesScratch{};
+    std::vector<VkBufferMemoryBarrier> m_uploadBarriers{};
 
     VkSampler m_sampler = VK_NULL_HANDLE;
     size_t m_currentDrawIndex = 0;
-    size_t m_imageCount = 0;
+    size_t m_framesInFlight = 0;
+    bool m_readbackEnabled = false;
+    int64_t m_lastReadbackFrame = -1;
+
+    [[nodiscard]] std::weak_ptr<VulkanResources> getObjectBufferResources() const override
+    {
+        return m_vulkanResources;
+    }
+
+    [[nodiscard]] size_t getObjectBufferFrames() const override { return m_framesInFlight; }
 
     void initializeSampler();
     void initializeDefaultMeshes();
     void onMeshCreated(const Mesh& mesh);
+    void uploadFrameTable();
+    void writeSceneDescriptorSets();
+    void collectTilemapTextureSlots();
+    void invalidateTilemapChunks(const std::vector<size_t>& changedTextures);
+    void moveChangedTextures(const std::vector<size_t>& changedTextures);
+
+    uint32_t addTextureSlot(VkImageView imageView, std::unique_ptr<Texture2D> texture, size_t managedTexture);
 
-    void updateCamera(const Camera& camera, size_t imageIndex);
+    void referenceTextureSlot(uint32_t textureSlot)
+    {
+        if (m_managedTextures[textureSlot] != UNMANAGED_TEXTURE)
+        {
+            m_textureResidency->reference(m_managedTextures[textureSlot]);
+        }
+    }
+
+    void updateCamera(const Camera& camera, size_t frameIndex);
+    void updateInstanceIndices();
     void updateObjectBuffers(
         VkCommandBuffer commandBuffer,
-        size_t imageIndex);
+        size_t frameIndex);
 
     void drawIndexed(
-        const SwapchainElement* currentImageElement,
-        size_t currentFrameIndex,
-        size_t pipelineIndex,
-        size_t firstDataInstanceIndex,
-        size_t lastDataInstanceIndex)
+        VkCommandBuffer commandBuffer,
+        size_t frameIndex,
+        size_t batchIndex)
     {
-        const auto& pipeline = *m_pipelines[pipelineIndex];
+        const DrawBatch& batch = m_drawBatches[batchIndex];
+        const auto& pipeline = *m_pipelines[batch.pipelineIndex];
         const IGenericBuffer& objects = *m_objectBuffers[pipeline.getDataBufferIndex()];
 
         vkCmdBindPipeline(
-            currentImageElement->commandBuffer,
+            commandBuffer,
             VK_PIPELINE_BIND_POINT_GRAPHICS,
             pipeline.getPipeline());
 
         std::vector<VkDescriptorSet> descriptorSets{};
-        descriptorSets.push_back(m_sceneDataDescriptorSets[currentFrameIndex]);
-        descriptorSets.push_back(objects.getDescriptorSet(currentFrameIndex));
-        descriptorSets.push_back(m_frameDataDescriptorSets[currentFrameIndex]);
+        descriptorSets.push_back(m_sceneDataDescriptorSets[frameIndex]);
+        descriptorSets.push_back(objects.getDescriptorSet(frameIndex));
+        descriptorSets.push_back(m_frameDataDescriptorSets[frameIndex]);
+        descriptorSets.push_back(m_vulkanResources->m_textureTable->getDescriptorSet());
 
         // Bind global descriptor set
         vkCmdBindDescriptorSets(
-            currentImageElement->commandBuffer,
+            commandBuffer,
             VK_PIPELINE_BIND_POINT_GRAPHICS,
             m_vulkanResources->m_pipelineLayout,
             0,
@@ -162,17 +320,28 @@ private:
 
         const Mesh& mesh = *m_meshes[0];
 
+        if (m_cullingActive)
+        {
+            vkCmdDrawIndexedIndirect(
+                commandBuffer,
+                m_cullingPass->getDrawCommandBuffer(frameIndex),
+                sizeof(VkDrawIndexedIndirectCommand) * batchIndex,
+                1,
+                sizeof(VkDrawIndexedIndirectCommand));
+            return;
+        }
+
         vkCmdDrawIndexed(
-            currentImageElement->commandBuffer,
+            commandBuffer,
             mesh.getIndices().size(),
-            (lastDataInstanceIndex - firstDataInstanceIndex) + 1,
+            (batch.lastKey - batch.firstKey) + 1,
             0,
             0,
-            firstDataInstanceIndex);
+            batch.firstKey);
     }
 
-    static void imageToAttachmentLayout(SwapchainElement* element);
-    static void imageToPresentLayout(SwapchainElement* element);
+    static void imageToAttachmentLayout(VkCommandBuffer commandBuffer, VkImage image);
+    static void imageToFinalLayout(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout layout);
 };
 
 #endif //VULKANRENDERER_H
@@ -6,15 +6,26 @@
 
 #include <set>
 #include <stdexcept>
+#include <string>
 #include <string.h>
 #include <vector>
 #include <array>
 
 #include "VulkanWindow.h"
+#include "Logger.h"
 
 VulkanResources::~VulkanResources()
 {
+    vkDeviceWaitIdle(m_logicalDevice);
+
     m_swapchain.reset();
+    m_offscreenTarget.reset();
+    m_frameRing.reset();
+    m_pipelineCache.reset();
+    m_textureTable.reset();
+    m_bufferUploadQueue.reset();
+    m_deletionQueue.reset();
+    m_memoryAllocator.reset();
 
     vkDestroyPipelineLayout(m_logicalDevice, m_pipelineLayout, m_allocator);
     vkDestroyDescriptorSetLayout(m_logicalDevice, m_descriptorSetLayout, m_allocator);
@@ -34,17 +45,36 @@ void VulkanResources::initialize(
 {
     initializeInstance(enableValidationLayers, validationLayers, instanceExtensions);
 
-    if (m_window->createSurface(m_instance, &m_surface) != VK_SUCCESS)
+    if (m_window && m_window->createSurface(m_instance, &m_surface) != VK_SUCCESS)
     {
         throw std::runtime_error("Failed to create Vulkan surface");
     }
 
     m_physicalDevice = pickPhysicalDevice();
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &m_physicalDeviceProperties);
+    vkGetPhysicalDeviceMemoryProperties(m_physicalDevice, &m_memoryProperties);
+
     m_graphicsQueueFamilyIndex = getQueueFamilyIndex(VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_TRANSFER_BIT);
 
     initializeLogicalDevice();
     vkGetDeviceQueue(m_logicalDevice, m_graphicsQueueFamilyIndex, 0, &m_graphicsQueue);
 
+    m_memoryAllocator = std::make_unique<MemoryAllocator>(m_physicalDevice, m_logicalDevice, m_allocator);
+    m_deletionQueue = std::make_unique<DeletionQueue>(m_logicalDevice, m_allocator, *m_memoryAllocator);
+    m_bufferUploadQueue = std::make_unique<BufferUploadQueue>();
+    m_textureTable = std::make_unique<BindlessTextureTable>(
+        m_physicalDevice,
+        m_logicalDevice,
+        m_allocator,
+        *m_deletionQueue);
+
+    // Relative to the working directory, which is the directory of the executable when started from the build tree
+    m_pipelineCache = std::make_unique<PipelineCache>(
+        m_physicalDeviceProperties,
+        m_logicalDevice,
+        m_allocator,
+        PIPELINE_CACHE_FILE);
+
     VkCommandPoolCreateInfo commandPoolCreateInfo = {};
     commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
     commandPoolCreateInfo.queueFamilyIndex = m_graphicsQueueFamilyIndex;
@@ -55,15 +85,31 @@ void VulkanResources::initialize(
         throw std::runtime_error("failed to create command pool!");
     }
 
-    const auto windowExtent = m_window->getWindowExtent();
-    m_swapchain = std::make_shared<Swapchain>(
-        m_physicalDevice,
-        m_logicalDevice,
-        m_surface,
-        m_commandPool,
-        m_allocator,
-        windowExtent.width,
-        windowExtent.height);
+    // Independent of the swapchain, so it survives recreating it
+    m_frameRing = std::make_unique<FrameRing>(m_logicalDevice, m_graphicsQueueFamilyIndex, m_allocator);
+    m_deletionQueue->setFramesInFlight(m_frameRing->getFramesInFlight());
+
+    if (m_window)
+    {
+        const auto windowExtent = m_window->getWindowExtent();
+        m_swapchain = std::make_shared<Swapchain>(
+            m_physicalDevice,
+            m_logicalDevice,
+            m_surface,
+            m_allocator,
+            windowExtent.width,
+            windowExtent.height);
+    }
+    else
+    {
+        m_offscreenTarget = std::make_unique<OffscreenTarget>(
+            m_logicalDevice,
+            m_allocator,
+            *m_memoryAllocator,
+            m_headlessExtent.width,
+            m_headlessExtent.height,
+            m_frameRing->getFramesInFlight());
+    }
 
     initializeDescriptorPool();
     initializeDescriptorSetLayout();
@@ -143,6 +189,90 @@ void VulkanResources::verifyValidationLayerSupport(const std::vector<const char*
     }
 }
 
+VkFormat VulkanResources::getColorFormat() const
+{
+    return m_swapchain ? m_swapchain->m_format.format : OffscreenTarget::FORMAT;
+}
+
+VkExtent2D VulkanResources::getRenderExtent() const
+{
+    if (m_swapchain)
+    {
+        return { m_swapchain->m_width, m_swapchain->m_height };
+    }
+
+    return { m_offscreenTarget->getWidth(), m_offscreenTarget->getHeight() };
+}
+
+std::vector<const char*> VulkanResources::getDeviceExtensions() const
+{
+    std::vector<const char*> extensions{};
+
+    for (const char* extension : DEVICE_EXTENSIONS)
+    {
+        // Without a surface there is nothing to present to
+        if (m_window || strcmp(extension, VK_KHR_SWAPCHAIN_EXTENSION_NAME) != 0)
+        {
+            extensions.push_back(extension);
+        }
+    }
+
+    return extensions;
+}
+
+/**
+ * Lists the features initializeLogicalDevice enables unconditionally that the device lacks, separated by commas.
+ */
+static std::string getMissingFeatures(VkPhysicalDevice physicalDevice)
+{
+    VkPhysicalDeviceTimelineSemaphoreFeatures timelineSemaphore
+    {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES,
+    };
+
+    VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexing
+    {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES,
+        .pNext = &timelineSemaphore,
+    };
+
+    VkPhysicalDeviceFeatures2 features
+    {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &descriptorIndexing,
+    };
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+
+    const std::pair<const char*, VkBool32> requiredFeatures[] =
+    {
+        { "samplerAnisotropy", features.features.samplerAnisotropy },
+        { "timelineSemaphore", timelineSemaphore.timelineSemaphore },
+        { "shaderSampledImageArrayNonUniformIndexing", descriptorIndexing.shaderSampledImageArrayNonUniformIndexing },
+        { "runtimeDescriptorArray", descriptorIndexing.runtimeDescriptorArray },
+        { "descriptorBindingVariableDescriptorCount", descriptorIndexing.descriptorBindingVariableDescriptorCount },
+        {
+            "descriptorBindingSampledImageUpdateAfterBind",
+            descriptorIndexing.descriptorBindingSampledImageUpdateAfterBind
+        },
+        {
+            "descriptorBindingUpdateUnusedWhilePending",
+            descriptorIndexing.descriptorBindingUpdateUnusedWhilePending
+        },
+        { "descriptorBindingPartiallyBound", descriptorIndexing.descriptorBindingPartiallyBound },
+    };
+
+    std::string missingFeatures{};
+    for (const auto& [name, supported] : requiredFeatures)
+    {
+        if (!supported)
+        {
+            missingFeatures += missingFeatures.empty() ? name : std::string(", ") + name;
+        }
+    }
+
+    return missingFeatures;
+}
+
 VkPhysicalDevice VulkanResources::pickPhysicalDevice()
 {
     uint32_t physicalDeviceCount = 0;
@@ -162,40 +292,68 @@ VkPhysicalDevice VulkanResources::pickPhysicalDevice()
         throw std::runtime_error("No physical devices found!");
     }
 
+    // Integrated and software devices are only picked when no discrete device is suitable
+    VkPhysicalDevice fallbackDevice = VK_NULL_HANDLE;
     VkPhysicalDeviceProperties physicalDeviceProperties{};
     for (const auto& physicalDevice : physicalDevices)
     {
         vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
-
-        if (physicalDeviceProperties.deviceType != VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
-        {
-            continue;
-        }
+        const std::string_view deviceName(physicalDeviceProperties.deviceName);
 
         uint32_t extensionCount;
         vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
 
-        if (extensionCount == 0)
-        {
-            continue;
-        }
-
         std::vector<VkExtensionProperties> availableExtensions(extensionCount);
         vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, availableExtensions.data());
 
-        std::set<std::string> requiredExtensions(DEVICE_EXTENSIONS.begin(), DEVICE_EXTENSIONS.end());
+        const auto deviceExtensions = getDeviceExtensions();
+        std::set<std::string> requiredExtensions(deviceExtensions.begin(), deviceExtensions.end());
         for (const auto& extension : availableExtensions)
         {
             requiredExtensions.erase(extension.extensionName);
         }
 
-        if (requiredExtensions.empty())
+        if (!requiredExtensions.empty())
+        {
+            Logger::log(
+                LogLevel::Warning,
+                "Vulkan",
+                "Skipping {}, it does not support the extension {}",
+                deviceName,
+                *requiredExtensions.begin());
+            continue;
+        }
+
+        const std::string missingFeatures = getMissingFeatures(physicalDevice);
+
+        if (!missingFeatures.empty())
+        {
+            Logger::log(
+                LogLevel::Warning,
+                "Vulkan",
+                "Skipping {}, it does not support {}",
+                deviceName,
+                missingFeatures);
+            continue;
+        }
+
+        if (physicalDeviceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
         {
             return physicalDevice;
         }
+
+        if (fallbackDevice == VK_NULL_HANDLE)
+        {
+            fallbackDevice = physicalDevice;
+        }
     }
 
-    return physicalDevices[0];
+    if (fallbackDevice == VK_NULL_HANDLE)
+    {
+        throw std::runtime_error("No physical device supports the required extensions and features, see the log");
+    }
+
+    return fallbackDevice;
 }
 
 void VulkanResources::initializeLogicalDevice()
@@ -207,12 +365,28 @@ void VulkanResources::initializeLogicalDevice()
     queueCreateInfo.queueCount = 1;
     queueCreateInfo.pQueuePriorities = priorities ;
 
+    VkPhysicalDeviceFeatures supportedFeatures{};
+    vkGetPhysicalDeviceFeatures(m_physicalDevice, &supportedFeatures);
+
     VkPhysicalDeviceFeatures deviceFeatures{};
     deviceFeatures.samplerAnisotropy = VK_TRUE;
 
+    // Optional, indirect draws of culled batches start at the batch's first instance
+    deviceFeatures.drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance;
+
+    // Optional, the GPU profiler counts shader invocations per scope
+    deviceFeatures.pipelineStatisticsQuery = supportedFeatures.pipelineStatisticsQuery;
+
+    VkPhysicalDeviceTimelineSemaphoreFeatures timelineSemaphore
+    {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES,
+        .timelineSemaphore = VK_TRUE,
+    };
+
     VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRendering
     {
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES,
+        .pNext = &timelineSemaphore,
         .dynamicRendering = VK_TRUE,
     };
 
@@ -221,6 +395,9 @@ void VulkanResources::initializeLogicalDevice()
     physicalDeviceDescriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
     physicalDeviceDescriptorIndexingFeatures.runtimeDescriptorArray = VK_TRUE;
     physicalDeviceDescriptorIndexingFeatures.descriptorBindingVariableDescriptorCount = VK_TRUE;
+    physicalDeviceDescriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    physicalDeviceDescriptorIndexingFeatures.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+    physicalDeviceDescriptorIndexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
     physicalDeviceDescriptorIndexingFeatures.pNext = &dynamicRendering;
 
     VkDeviceCreateInfo deviceCreateInfo = {};
@@ -228,14 +405,17 @@ void VulkanResources::initializeLogicalDevice()
     deviceCreateInfo.queueCreateInfoCount = 1;
     deviceCreateInfo.pQueueCreateInfos = &queueCreateInfo;
     deviceCreateInfo.pNext = &physicalDeviceDescriptorIndexingFeatures;
-    deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(DEVICE_EXTENSIONS.size());
-    deviceCreateInfo.ppEnabledExtensionNames = DEVICE_EXTENSIONS.data();
+    const auto deviceExtensions = getDeviceExtensions();
+    deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
+    deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions.data();
     deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
 
     if (vkCreateDevice(m_physicalDevice, &deviceCreateInfo, m_allocator, &m_logicalDevice) != VK_SUCCESS)
     {
         throw std::runtime_error("failed to create logical device!");
     }
+
+    m_enabledFeatures = deviceFeatures;
 }
 
 
@@ -265,22 +445,23 @@ uint32_t VulkanResources::getQueueFamilyIndex(VkQueueFlags queueFlags)
 
 void VulkanResources::initializeDescriptorPool()
 {
-    const auto swapchainImageCount = m_swapchain->getImageCount();
+    // Scene sets are reallocated while the old ones still wait in the deletion queue, so twice the frames in flight
+    const auto frameSlotCount = m_frameRing->getFramesInFlight() * 2;
 
     VkPhysicalDeviceProperties properties{};
     vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
 
     std::array<VkDescriptorPoolSize, 3> poolSizes{};
     poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSizes[0].descriptorCount = swapchainImageCount;
+    poolSizes[0].descriptorCount = frameSlotCount;
     poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[1].descriptorCount = swapchainImageCount * 100;
+    poolSizes[1].descriptorCount = frameSlotCount * 100;
     poolSizes[2].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-    poolSizes[2].descriptorCount = swapchainImageCount;
+    poolSizes[2].descriptorCount = frameSlotCount * 100;
 
     VkDescriptorPoolCreateInfo descriptorPoolInfo{};
     descriptorPoolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    descriptorPoolInfo.maxSets = swapchainImageCount * 10000;
+    descriptorPoolInfo.maxSets = frameSlotCount * 10000;
     descriptorPoolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
     descriptorPoolInfo.pPoolSizes = poolSizes.data();
     descriptorPoolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
@@ -298,15 +479,22 @@ void VulkanResources::initializeDescriptorPool()
 
 void VulkanResources::recreateSwapchain()
 {
+    if (!m_window)
+    {
+        return;
+    }
+
     const auto windowExtent = m_window->getWindowExtent();
     vkDeviceWaitIdle(m_logicalDevice);
 
+    // Nothing is in flight anymore, which also makes every pending deletion safe
+    m_deletionQueue->flush();
+
     m_swapchain.reset();
     m_swapchain = std::make_shared<Swapchain>(
         m_physicalDevice,
         m_logicalDevice,
         m_surface,
-        m_commandPool,
         m_allocator,
         windowExtent.width,
         windowExtent.height);
@@ -318,16 +506,16 @@ void VulkanResources::initializeDescriptorSetLayout()
     cameraBinding.binding = 0;
     cameraBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
     cameraBinding.descriptorCount = 1;
-    cameraBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    cameraBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
 
-    VkDescriptorSetLayoutBinding samplerBinding{};
-    samplerBinding.binding = 1;
-    samplerBinding.descriptorCount = 12;
-    samplerBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    samplerBinding.pImmutableSamplers = nullptr;
-    samplerBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    // Textures are not part of this set, every pipeline samples them from the bindless texture table
+    VkDescriptorSetLayoutBinding frameTableBinding{};
+    frameTableBinding.binding = 2;
+    frameTableBinding.descriptorCount = 1;
+    frameTableBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    frameTableBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
 
-    std::array bindings = { cameraBinding, samplerBinding };
+    std::array bindings = { cameraBinding, frameTableBinding };
     VkDescriptorSetLayoutCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
     createInfo.bindingCount = static_cast<uint32_t>(bindings.size());
@@ -351,7 +539,8 @@ void VulkanResources::initializeObjectsBufferLayout()
     objectsBufferBinding.binding = 0;
     objectsBufferBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
     objectsBufferBinding.descriptorCount = 1;
-    objectsBufferBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    objectsBufferBinding.stageFlags =
+        VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
 
     VkDescriptorSetLayoutCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
@@ -397,10 +586,11 @@ void VulkanResources::initializeFrameDataLayout()
 
 void VulkanResources::initializePipelineLayout()
 {
-    std::vector<VkDescriptorSetLayout> layouts(3);
+    std::vector<VkDescriptorSetLayout> layouts(4);
     layouts[0] = m_descriptorSetLayout;
     layouts[1] = m_descriptorSetLayoutObjectsBuffer;
     layouts[2] = m_descriptorSetLayoutFrameGlobals;
+    layouts[3] = m_textureTable->getLayout();
 
     VkPipelineLayoutCreateInfo pipelineLayoutInfo{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
     pipelineLayoutInfo.setLayoutCount = layouts.size();
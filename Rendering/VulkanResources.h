@@ -9,11 +9,20 @@
 #include <vector>
 #include <vulkan/vulkan.h>
 
+#include "BindlessTextureTable.h"
+#include "BufferUploadQueue.h"
+#include "DeletionQueue.h"
+#include "FrameRing.h"
+#include "MemoryAllocator.h"
+#include "OffscreenTarget.h"
+#include "PipelineCache.h"
 #include "Swapchain.h"
 #include "VulkanWindow.h"
 
 class VulkanResources {
 public:
+    static constexpr const char* PIPELINE_CACHE_FILE = "pipeline_cache.bin";
+
     VkAllocationCallbacks* m_allocator = nullptr;
 
     VkInstance m_instance = VK_NULL_HANDLE;
@@ -27,10 +36,27 @@ public:
     VkDescriptorSetLayout m_descriptorSetLayoutFrameGlobals = VK_NULL_HANDLE;
     VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
 
+    VkPhysicalDeviceProperties m_physicalDeviceProperties{};
+    VkPhysicalDeviceMemoryProperties m_memoryProperties{};
+    VkPhysicalDeviceFeatures m_enabledFeatures{};
+
     uint32_t m_graphicsQueueFamilyIndex = 0;
     VkCommandPool m_commandPool = VK_NULL_HANDLE;
 
+    std::unique_ptr<MemoryAllocator> m_memoryAllocator;
+    std::unique_ptr<DeletionQueue> m_deletionQueue;
+    std::unique_ptr<BufferUploadQueue> m_bufferUploadQueue;
+    std::unique_ptr<BindlessTextureTable> m_textureTable;
+    std::unique_ptr<PipelineCache> m_pipelineCache;
+    std::unique_ptr<FrameRing> m_frameRing;
+
     explicit VulkanResources(const std::shared_ptr<VulkanWindow>& window): m_window(window) {}
+
+    /**
+     * Headless resources without surface and swapchain, frames are rendered into an offscreen target of extent.
+     * Needs no window system, so it also runs on software implementations like lavapipe.
+     */
+    explicit VulkanResources(WindowExtent extent): m_headlessExtent(extent) {}
     ~VulkanResources();
 
     void initialize(
@@ -50,9 +76,24 @@ public:
         return m_swapchain;
     }
 
+    [[nodiscard]] bool isHeadless() const { return m_window == nullptr; }
+
+    /**
+     * Null unless headless.
+     */
+    [[nodiscard]] OffscreenTarget* getOffscreenTarget() const { return m_offscreenTarget.get(); }
+
+    /**
+     * Format and extent of the images frames are rendered into, the swapchain's or the offscreen target's.
+     */
+    [[nodiscard]] VkFormat getColorFormat() const;
+    [[nodiscard]] VkExtent2D getRenderExtent() const;
+
 private:
     std::shared_ptr<VulkanWindow> m_window;
     std::shared_ptr <Swapchain> m_swapchain;
+    WindowExtent m_headlessExtent{};
+    std::unique_ptr<OffscreenTarget> m_offscreenTarget;
 
     const std::vector<const char*> DEVICE_EXTENSIONS = {
         VK_KHR_SWAPCHAIN_EXTENSION_NAME,
@@ -64,6 +105,7 @@ private:
         const std::vector<const char*>& validationLayers,
         const std::vector<const char*>& instanceExtensions);
 
+    [[nodiscard]] std::vector<const char*> getDeviceExtensions() const;
     VkPhysicalDevice pickPhysicalDevice();
     uint32_t getQueueFamilyIndex(VkQueueFlags flags);
     void initializeLogicalDevice();
@@ -2,16 +2,85 @@
 #define GLFW_INCLUDE_VULKAN
 
 #include <iostream>
+#include <string>
 
 #include "Core/Game.h"
+#include "Core/HeadlessRun.h"
+#include "Rendering/CpuProfiler.h"
+#include "Rendering/Logger.h"
+#include "Rendering/NullRenderer.h"
 
-int main()
+namespace
 {
+    // Opens in chrome://tracing or the Perfetto UI, only builds with the CPU profiler record anything
+    void writeCpuTrace()
+    {
+#if CPU_PROFILER_ENABLED
+        CpuProfiler::writeChromeTrace("cpu_trace.json");
+        Logger::log(LogLevel::Info, "Profiler", "Wrote the CPU trace to cpu_trace.json");
+#endif
+    }
+}
+
+int main(int argc, char** argv)
+{
+    // --headless [frames] [output.png] [--no-chunk-cache] renders without a window, for benchmarks and golden images
+    if (argc > 1 && std::string(argv[1]) == "--headless")
+    {
+        try
+        {
+            HeadlessRun headlessRun(1280, 768);
+            headlessRun.setChunkCacheEnabled(!(argc > 4 && std::string(argv[4]) == "--no-chunk-cache"));
+            headlessRun.run(
+                argc > 2 ? static_cast<uint32_t>(std::stoul(argv[2])) : 100,
+                argc > 3 ? std::filesystem::path(argv[3]) : std::filesystem::path());
+            writeCpuTrace();
+        }
+        catch (const std::exception& ex)
+        {
+            std::cout << ex.what() << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
+    // --null-renderer [frames] runs the game loop without a device, for measuring the CPU side alone
+    if (argc > 1 && std::string(argv[1]) == "--null-renderer")
+    {
+        try
+        {
+            auto renderer = std::make_unique<NullRenderer>();
+            const NullRenderer& nullRenderer = *renderer;
+
+            Game game(std::move(renderer), WindowExtent{ 1280, 768 });
+            game.RunFrames(argc > 2 ? static_cast<uint32_t>(std::stoul(argv[2])) : 10000);
+
+            const NullRendererStatistics& statistics = nullRenderer.getStatistics();
+            Logger::log(
+                LogLevel::Info,
+                "NullRenderer",
+                "{} draw requests in {} draw calls over {} frames",
+                statistics.drawRequests,
+                statistics.drawCalls,
+                statistics.frames);
+            writeCpuTrace();
+        }
+        catch (const std::exception& ex)
+        {
+            std::cout << ex.what() << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
     Game game{};
 
     try
     {
         game.RunLoop();
+        writeCpuTrace();
     }
     catch (std::runtime_error ex)
     {